@@ -0,0 +1,266 @@
+#include <CppScript/ArrayKernels.h>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(CPPSCRIPT_FLOAT_SINGLE) && !defined(CPPSCRIPT_FLOAT_EXTENDED)
+#define CPPSCRIPT_ARRAY_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define CPPSCRIPT_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CPPSCRIPT_TARGET(isa)
+#endif
+
+namespace CppScript
+{
+
+namespace
+{
+
+void addFloatsScalar(FloatValue* destination, const FloatValue* source, std::size_t size)
+{
+	for (std::size_t i = 0; i < size; ++i)
+		destination[i] += source[i];
+}
+
+void addIntsScalar(IntValue* destination, const IntValue* source, std::size_t size)
+{
+	for (std::size_t i = 0; i < size; ++i)
+		destination[i] += source[i];
+}
+
+void addFloatScalarScalar(FloatValue* destination, FloatValue source, std::size_t size)
+{
+	for (std::size_t i = 0; i < size; ++i)
+		destination[i] += source;
+}
+
+void addIntScalarScalar(IntValue* destination, IntValue source, std::size_t size)
+{
+	for (std::size_t i = 0; i < size; ++i)
+		destination[i] += source;
+}
+
+FloatValue sumFloatsScalar(const FloatValue* source, std::size_t size)
+{
+	FloatValue sum = 0;
+	for (std::size_t i = 0; i < size; ++i)
+		sum += source[i];
+	return sum;
+}
+
+IntValue sumIntsScalar(const IntValue* source, std::size_t size)
+{
+	IntValue sum = 0;
+	for (std::size_t i = 0; i < size; ++i)
+		sum += source[i];
+	return sum;
+}
+
+bool equalFloatsScalar(const FloatValue* left, const FloatValue* right, std::size_t size)
+{
+	for (std::size_t i = 0; i < size; ++i)
+		if (!(left[i] == right[i]))
+			return false;
+	return true;
+}
+
+const ArrayKernels scalarKernels{ "scalar", addFloatsScalar, addIntsScalar, addFloatScalarScalar, addIntScalarScalar,
+	sumFloatsScalar, sumIntsScalar, equalFloatsScalar };
+
+
+#ifdef CPPSCRIPT_ARRAY_SIMD
+
+void addFloatsSse2(double* destination, const double* source, std::size_t size)
+{
+	std::size_t i = 0;
+	for (; i + 2 <= size; i += 2)
+		_mm_storeu_pd(destination + i, _mm_add_pd(_mm_loadu_pd(destination + i), _mm_loadu_pd(source + i)));
+	addFloatsScalar(destination + i, source + i, size - i);
+}
+
+void addIntsSse2(IntValue* destination, const IntValue* source, std::size_t size)
+{
+	std::size_t i = 0;
+	for (; i + 2 <= size; i += 2)
+	{
+		auto* target = reinterpret_cast<__m128i*>(destination + i);
+		_mm_storeu_si128(target, _mm_add_epi64(_mm_loadu_si128(target), _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i))));
+	}
+	addIntsScalar(destination + i, source + i, size - i);
+}
+
+void addFloatScalarSse2(double* destination, double source, std::size_t size)
+{
+	auto sourceVector = _mm_set1_pd(source);
+	std::size_t i = 0;
+	for (; i + 2 <= size; i += 2)
+		_mm_storeu_pd(destination + i, _mm_add_pd(_mm_loadu_pd(destination + i), sourceVector));
+	addFloatScalarScalar(destination + i, source, size - i);
+}
+
+void addIntScalarSse2(IntValue* destination, IntValue source, std::size_t size)
+{
+	auto sourceVector = _mm_set1_epi64x(source);
+	std::size_t i = 0;
+	for (; i + 2 <= size; i += 2)
+	{
+		auto* target = reinterpret_cast<__m128i*>(destination + i);
+		_mm_storeu_si128(target, _mm_add_epi64(_mm_loadu_si128(target), sourceVector));
+	}
+	addIntScalarScalar(destination + i, source, size - i);
+}
+
+double sumFloatsSse2(const double* source, std::size_t size)
+{
+	auto sumVector = _mm_setzero_pd();
+	std::size_t i = 0;
+	for (; i + 2 <= size; i += 2)
+		sumVector = _mm_add_pd(sumVector, _mm_loadu_pd(source + i));
+	double lanes[2];
+	_mm_storeu_pd(lanes, sumVector);
+	return lanes[0] + lanes[1] + sumFloatsScalar(source + i, size - i);
+}
+
+IntValue sumIntsSse2(const IntValue* source, std::size_t size)
+{
+	auto sumVector = _mm_setzero_si128();
+	std::size_t i = 0;
+	for (; i + 2 <= size; i += 2)
+		sumVector = _mm_add_epi64(sumVector, _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i)));
+	IntValue lanes[2];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sumVector);
+	return lanes[0] + lanes[1] + sumIntsScalar(source + i, size - i);
+}
+
+bool equalFloatsSse2(const double* left, const double* right, std::size_t size)
+{
+	std::size_t i = 0;
+	for (; i + 2 <= size; i += 2)
+		if (_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(left + i), _mm_loadu_pd(right + i))) != 0x3)
+			return false;
+	return equalFloatsScalar(left + i, right + i, size - i);
+}
+
+const ArrayKernels sse2Kernels{ "sse2", addFloatsSse2, addIntsSse2, addFloatScalarSse2, addIntScalarSse2,
+	sumFloatsSse2, sumIntsSse2, equalFloatsSse2 };
+
+
+CPPSCRIPT_TARGET("avx2") void addFloatsAvx2(double* destination, const double* source, std::size_t size)
+{
+	std::size_t i = 0;
+	for (; i + 4 <= size; i += 4)
+		_mm256_storeu_pd(destination + i, _mm256_add_pd(_mm256_loadu_pd(destination + i), _mm256_loadu_pd(source + i)));
+	addFloatsSse2(destination + i, source + i, size - i);
+}
+
+CPPSCRIPT_TARGET("avx2") void addIntsAvx2(IntValue* destination, const IntValue* source, std::size_t size)
+{
+	std::size_t i = 0;
+	for (; i + 4 <= size; i += 4)
+	{
+		auto* target = reinterpret_cast<__m256i*>(destination + i);
+		_mm256_storeu_si256(target, _mm256_add_epi64(_mm256_loadu_si256(target), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i))));
+	}
+	addIntsSse2(destination + i, source + i, size - i);
+}
+
+CPPSCRIPT_TARGET("avx2") void addFloatScalarAvx2(double* destination, double source, std::size_t size)
+{
+	auto sourceVector = _mm256_set1_pd(source);
+	std::size_t i = 0;
+	for (; i + 4 <= size; i += 4)
+		_mm256_storeu_pd(destination + i, _mm256_add_pd(_mm256_loadu_pd(destination + i), sourceVector));
+	addFloatScalarSse2(destination + i, source, size - i);
+}
+
+CPPSCRIPT_TARGET("avx2") void addIntScalarAvx2(IntValue* destination, IntValue source, std::size_t size)
+{
+	auto sourceVector = _mm256_set1_epi64x(source);
+	std::size_t i = 0;
+	for (; i + 4 <= size; i += 4)
+	{
+		auto* target = reinterpret_cast<__m256i*>(destination + i);
+		_mm256_storeu_si256(target, _mm256_add_epi64(_mm256_loadu_si256(target), sourceVector));
+	}
+	addIntScalarSse2(destination + i, source, size - i);
+}
+
+CPPSCRIPT_TARGET("avx2") double sumFloatsAvx2(const double* source, std::size_t size)
+{
+	auto sumVector = _mm256_setzero_pd();
+	std::size_t i = 0;
+	for (; i + 4 <= size; i += 4)
+		sumVector = _mm256_add_pd(sumVector, _mm256_loadu_pd(source + i));
+	double lanes[4];
+	_mm256_storeu_pd(lanes, sumVector);
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sumFloatsSse2(source + i, size - i);
+}
+
+CPPSCRIPT_TARGET("avx2") IntValue sumIntsAvx2(const IntValue* source, std::size_t size)
+{
+	auto sumVector = _mm256_setzero_si256();
+	std::size_t i = 0;
+	for (; i + 4 <= size; i += 4)
+		sumVector = _mm256_add_epi64(sumVector, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i)));
+	IntValue lanes[4];
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sumVector);
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumIntsSse2(source + i, size - i);
+}
+
+CPPSCRIPT_TARGET("avx2") bool equalFloatsAvx2(const double* left, const double* right, std::size_t size)
+{
+	std::size_t i = 0;
+	for (; i + 4 <= size; i += 4)
+		if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(left + i), _mm256_loadu_pd(right + i), _CMP_EQ_OQ)) != 0xf)
+			return false;
+	return equalFloatsSse2(left + i, right + i, size - i);
+}
+
+const ArrayKernels avx2Kernels{ "avx2", addFloatsAvx2, addIntsAvx2, addFloatScalarAvx2, addIntScalarAvx2,
+	sumFloatsAvx2, sumIntsAvx2, equalFloatsAvx2 };
+
+
+bool hasAvx2()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid(info, 1);
+	constexpr int osxsave = 1 << 27, avx = 1 << 28;
+	if ((info[2] & (osxsave | avx)) != (osxsave | avx) || (_xgetbv(0) & 0x6) != 0x6)
+		return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+}
+
+
+const ArrayKernels& ArrayKernels::get()
+{
+#ifdef CPPSCRIPT_ARRAY_SIMD
+	static const ArrayKernels& kernels = hasAvx2() ? avx2Kernels : sse2Kernels;
+	return kernels;
+#else
+	return scalarKernels;
+#endif
+}
+
+const ArrayKernels& ArrayKernels::getScalar()
+{
+	return scalarKernels;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <CppScript/Types.h>
+
+
+namespace CppScript
+{
+
+	// Element-wise and reduction kernels of numeric arrays. The best set for the running CPU
+	// (AVX2, SSE2 or plain loops) is chosen once, SIMD sets are only built for double floats on x86-64.
+	// Vector sums add the elements in a different order than the scalar loop.
+	struct ArrayKernels
+	{
+		const char* name;
+		void (*addFloats)(FloatValue* destination, const FloatValue* source, std::size_t size);
+		void (*addInts)(IntValue* destination, const IntValue* source, std::size_t size);
+		void (*addFloatScalar)(FloatValue* destination, FloatValue source, std::size_t size);
+		void (*addIntScalar)(IntValue* destination, IntValue source, std::size_t size);
+		FloatValue (*sumFloats)(const FloatValue* source, std::size_t size);
+		IntValue (*sumInts)(const IntValue* source, std::size_t size);
+		bool (*equalFloats)(const FloatValue* left, const FloatValue* right, std::size_t size);
+
+		static const ArrayKernels& get();
+		static const ArrayKernels& getScalar();
+	};
+
+}
\ No newline at end of file
@@ -3,19 +3,24 @@
 namespace CppScript
 {
 
+template<> TypeId<IntValue> Type<IntValue>::typeId{ "int" };
 template class Type<IntValue>;
-TypeId<IntValue> Type<IntValue>::typeId{ "int" };
 
+template<> TypeId<FloatValue> Type<FloatValue>::typeId{ "float" };
 template class Type<FloatValue>;
-TypeId<FloatValue> Type<FloatValue>::typeId{ "float" };
 
+template<> TypeId<BoolValue> Type<BoolValue>::typeId{ "bool" };
 template class Type<BoolValue>;
-TypeId<BoolValue> Type<BoolValue>::typeId{ "bool" };
 
 const TypeBase::Ref TypeOperations<BoolValue>::trueValue{ TypeBool::create(true) };
 const TypeBase::Ref TypeOperations<BoolValue>::falseValue{ TypeBool::create(false) };
 
 
+bool TypeOperations<IntValue>::isClonable() const noexcept
+{
+	return true;
+}
+
 TypeBase::Ref TypeOperations<IntValue>::clone() const
 {
 	return Type<IntValue>::create(getThis().get());
@@ -23,8 +28,10 @@ TypeBase::Ref TypeOperations<IntValue>::clone() const
 
 TypeBase::Ref TypeOperations<IntValue>::operator+=(const TypeBase& obj)
 {
+	if (isShared())
+		return *clone() += obj;
 	getThis().get() += obj.as<IntValue>();
-	return shared_from_this();
+	return getRef();
 }
 
 bool TypeOperations<IntValue>::operator==(const TypeBase& obj) const
@@ -52,6 +59,11 @@ Type<IntValue>& TypeOperations<IntValue>::getThis()
 }
 
 
+bool TypeOperations<FloatValue>::isClonable() const noexcept
+{
+	return true;
+}
+
 TypeBase::Ref TypeOperations<FloatValue>::clone() const
 {
 	return Type<FloatValue>::create(getThis().get());
@@ -66,8 +78,10 @@ static FloatValue getFloatOrIntAsFloat(const TypeBase& obj)
 
 TypeBase::Ref TypeOperations<FloatValue>::operator+=(const TypeBase& obj)
 {
+	if (isShared())
+		return *clone() += obj;
 	getThis().get() += getFloatOrIntAsFloat(obj);
-	return shared_from_this();
+	return getRef();
 }
 
 bool TypeOperations<FloatValue>::operator==(const TypeBase& obj) const
@@ -91,6 +105,11 @@ Type<FloatValue>& TypeOperations<FloatValue>::getThis()
 }
 
 
+bool TypeOperations<BoolValue>::isClonable() const noexcept
+{
+	return true;
+}
+
 TypeBase::Ref TypeOperations<BoolValue>::clone() const
 {
 	return getThis().get() ? trueValue : falseValue;
@@ -9,6 +9,7 @@ namespace CppScript
 	template <> class TypeOperations<IntValue> : public TypeBase
 	{
 	public:
+		virtual bool isClonable() const noexcept override;
 		virtual TypeBase::Ref clone() const override;
 		virtual TypeBase::Ref operator+=(const TypeBase& obj) override;
 		virtual bool operator==(const TypeBase& obj) const override;
@@ -22,6 +23,7 @@ namespace CppScript
 	template <> class TypeOperations<FloatValue> : public TypeBase
 	{
 	public:
+		virtual bool isClonable() const noexcept override;
 		virtual TypeBase::Ref clone() const override;
 		virtual TypeBase::Ref operator+=(const TypeBase& obj) override;
 		virtual bool operator==(const TypeBase& obj) const override;
@@ -35,6 +37,7 @@ namespace CppScript
 	template <> class TypeOperations<BoolValue> : public TypeBase
 	{
 	public:
+		virtual bool isClonable() const noexcept override;
 		virtual TypeBase::Ref clone() const override;
 		virtual bool operator==(const TypeBase& obj) const override;
 		virtual bool operator<(const TypeBase& obj) const override;
@@ -60,21 +63,28 @@ namespace CppScript
 	{
 	public:
 		ValueOverflow(const S sourceVal) noexcept : sourceValue(sourceVal)
-		{
-			std::ostringstream messageStream;
-			messageStream << "Value: " << sourceValue << " is outside the range of target type: "
-				<< std::numeric_limits<T>::lowest() << " : " << std::numeric_limits<T>::max();
-			message = messageStream.str();
-		}
+		{}
 
 		virtual const char* what() const noexcept override
 		{
+			if (message.empty())
+				try
+				{
+					std::ostringstream messageStream;
+					messageStream << "Value: " << sourceValue << " is outside the range of target type: "
+						<< std::numeric_limits<T>::lowest() << " : " << std::numeric_limits<T>::max();
+					message = messageStream.str();
+				}
+				catch (const std::exception&)
+				{
+					return "value overflow";
+				}
 			return message.c_str();
 		}
 
 	private:
 		const S sourceValue;
-		std::string message;
+		mutable std::string message;
 	};
 
 
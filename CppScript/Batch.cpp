@@ -0,0 +1,153 @@
+#include <CppScript/Batch.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace CppScript
+{
+
+ColumnTable::ColumnTable(std::size_t rows) noexcept : rowCount(rows)
+{}
+
+std::size_t ColumnTable::getRowCount() const noexcept
+{
+	return rowCount;
+}
+
+bool ColumnTable::contains(const std::string& name) const
+{
+	return columns.find(name) != columns.end();
+}
+
+NumericArray& ColumnTable::get(const std::string& name)
+{
+	return columns.at(name);
+}
+
+const NumericArray& ColumnTable::get(const std::string& name) const
+{
+	return columns.at(name);
+}
+
+NumericArray& ColumnTable::set(const std::string& name, NumericArray column)
+{
+	if (columns.empty() && rowCount == 0)
+		rowCount = column.size();
+	if (column.size() != rowCount)
+		throw std::invalid_argument{ "Column row count does not match the table" };
+	return columns.insert_or_assign(name, std::move(column)).first->second;
+}
+
+
+BatchExecutor::BatchExecutor(ColumnTable& table) : columns(table)
+{}
+
+ColumnTable& BatchExecutor::getColumns()
+{
+	return columns;
+}
+
+NumericArray BatchExecutor::execute(const Program& program)
+{
+	if (registers.size() < program.registerCount)
+	{
+		registers.resize(program.registerCount);
+		registerScalars.resize(program.registerCount);
+		registerColumns.resize(program.registerCount);
+	}
+	auto* reg = registers.data();
+	for (const auto& instruction : program.code)
+	{
+		auto& target = reg[instruction.target];
+		switch (instruction.code)
+		{
+		case OpCode::Value:
+			target = { program.constants[instruction.operand], nullptr, false };
+			break;
+		case OpCode::Read:
+			target = { nullptr, &getVariable(program.variables[instruction.operand]), false };
+			break;
+		case OpCode::Assign:
+		{
+			const auto& name = program.variables[instruction.operand].name.str();
+			auto* column = target.column ? &columns.set(name, *target.column) : &columns.set(name, broadcast(*target.scalar));
+			target = { nullptr, column, false };
+			break;
+		}
+		case OpCode::Clone:
+		{
+			const auto& source = reg[instruction.operand];
+			if (source.column)
+			{
+				registerColumns[instruction.target] = *source.column;
+				target = { nullptr, &registerColumns[instruction.target], true };
+			}
+			else
+			{
+				registerScalars[instruction.target] = *source.scalar;
+				target = { &registerScalars[instruction.target], nullptr, true };
+			}
+			break;
+		}
+		case OpCode::Add:
+		{
+			const auto& source = reg[instruction.operand];
+			if (target.scalar && source.column)
+			{
+				registerColumns[instruction.target] = broadcast(*target.scalar);
+				target = { nullptr, &registerColumns[instruction.target], true };
+			}
+			if (target.scalar)
+			{
+				// the sum goes to the register, so that literals stay as they are
+				auto sum = *target.scalar;
+				sum += *source.scalar;
+				registerScalars[instruction.target] = std::move(sum);
+				target = { &registerScalars[instruction.target], nullptr, true };
+			}
+			else if (source.column)
+				*target.column += *source.column;
+			else if (source.scalar->getKind() == Value::Kind::Int)
+				*target.column += source.scalar->as<IntValue>();
+			else if (source.scalar->getKind() == Value::Kind::Float)
+				*target.column += source.scalar->as<FloatValue>();
+			else
+				throw InvalidOperation{ source.scalar->getId().getName(), "Batch column addition" };
+			break;
+		}
+		case OpCode::Execute:
+			throw InvalidOperation{ Operation::getName(program.operations[instruction.operand]->getType()).c_str(), "Batch execution" };
+		}
+	}
+	return reg[0].column ? *reg[0].column : broadcast(*reg[0].scalar);
+}
+
+NumericArray BatchExecutor::broadcast(const Value& value) const
+{
+	auto rows = columns.getRowCount();
+	switch (value.getKind())
+	{
+	case Value::Kind::Int:
+	{
+		NumericArray column{ NumericArray::ElementKind::Int, rows };
+		std::fill_n(column.getInts(), rows, value.as<IntValue>());
+		return column;
+	}
+	case Value::Kind::Float:
+	{
+		NumericArray column{ NumericArray::ElementKind::Float, rows };
+		std::fill_n(column.getFloats(), rows, value.as<FloatValue>());
+		return column;
+	}
+	default:
+		throw InvalidOperation{ value.getId().getName(), "Batch column" };
+	}
+}
+
+NumericArray& BatchExecutor::getVariable(const Variable& variable)
+{
+	if (!columns.contains(variable.name.str()))
+		throw std::out_of_range{ "Batch column is not set" };
+	return columns.get(variable.name.str());
+}
+
+}
\ No newline at end of file
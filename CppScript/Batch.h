@@ -0,0 +1,61 @@
+#pragma once
+
+#include <CppScript/Execution.h>
+#include <CppScript/NumericArray.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CppScript
+{
+
+// Named numeric columns of equally many rows, the variables of a batch run.
+class ColumnTable
+{
+public:
+	ColumnTable() noexcept = default;
+	explicit ColumnTable(std::size_t rows) noexcept;
+
+	std::size_t getRowCount() const noexcept;
+
+	bool contains(const std::string& name) const;
+	NumericArray& get(const std::string& name);
+	const NumericArray& get(const std::string& name) const;
+	NumericArray& set(const std::string& name, NumericArray column);
+
+private:
+	std::size_t rowCount{ 0 };
+	std::unordered_map<std::string, NumericArray> columns;
+};
+
+
+// Runs a compiled program over all rows of a column table at once, every instruction
+// becomes one column kernel. Literals stay scalars and are broadcast when combined with columns.
+// The result is the same as running the program row by row.
+class BatchExecutor
+{
+public:
+	explicit BatchExecutor(ColumnTable& table);
+
+	ColumnTable& getColumns();
+
+	NumericArray execute(const Program& program);
+
+private:
+	struct Register
+	{
+		const Value* scalar;
+		NumericArray* column;
+		bool isOwned;
+	};
+
+	NumericArray broadcast(const Value& value) const;
+	NumericArray& getVariable(const Variable& variable);
+
+	ColumnTable& columns;
+	std::vector<Register> registers;
+	std::vector<Value> registerScalars;
+	std::vector<NumericArray> registerColumns;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,344 @@
+#include <CppScript/Binary.h>
+#include <CppScript/NumericArray.h>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CppScript
+{
+
+static constexpr std::uint8_t noOperation = 0xff;
+
+static std::size_t getElementSize(NumericArray::ElementKind elementKind)
+{
+	return elementKind == NumericArray::ElementKind::Int ? sizeof(IntValue) : sizeof(FloatValue);
+}
+
+
+InvalidBinaryProgram::InvalidBinaryProgram(const char* reason) noexcept
+{
+	std::ostringstream messageStream;
+	messageStream << "Invalid binary program: " << reason;
+	message = messageStream.str();
+}
+
+const char* InvalidBinaryProgram::what() const noexcept
+{
+	return message.c_str();
+}
+
+
+template <typename T> void BinaryWriter::write(const T& value)
+{
+	const auto* bytes = reinterpret_cast<const char*>(&value);
+	program.insert(program.end(), bytes, bytes + sizeof(T));
+}
+
+void BinaryWriter::serialize(Operation::Ref& obj)
+{
+	if (!obj)
+	{
+		write(noOperation);
+		return;
+	}
+	write(std::uint8_t(obj->getType()));
+	obj->serialize(*this);
+}
+
+void BinaryWriter::serialize(Value& value)
+{
+	write(std::uint8_t(value.getKind()));
+	switch (value.getKind())
+	{
+	case Value::Kind::Int:
+		write(value.as<IntValue>());
+		break;
+	case Value::Kind::Float:
+		write(value.as<FloatValue>());
+		break;
+	case Value::Kind::Bool:
+		write(std::uint8_t(value.as<BoolValue>()));
+		break;
+	case Value::Kind::Object:
+	{
+		if (!(value.getId() == TypeArray::id()))
+			throw InvalidOperation{ value.getId().getName(), "Binary serialization" };
+		const auto& array = value.as<NumericArray>();
+		write(std::uint8_t(array.getElementKind()));
+		write(std::uint64_t(array.size()));
+		const auto* elements = array.getElementKind() == NumericArray::ElementKind::Int
+			? static_cast<const void*>(array.getInts()) : static_cast<const void*>(array.getFloats());
+		const auto* bytes = static_cast<const char*>(elements);
+		program.insert(program.end(), bytes, bytes + array.size() * getElementSize(array.getElementKind()));
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void BinaryWriter::serialize(std::string& value)
+{
+	writeString(value);
+}
+
+void BinaryWriter::serialize(Variable& value)
+{
+	writeString(value.name.str());
+}
+
+void BinaryWriter::writeString(const std::string& value)
+{
+	auto stringPos = stringIds.try_emplace(value, std::uint32_t(strings.size()));
+	if (stringPos.second)
+	{
+		strings.push_back(&stringPos.first->first);
+		stringTableSize += std::uint32_t(sizeof(std::uint32_t) + value.size());
+	}
+	write(stringPos.first->second);
+}
+
+std::vector<char> BinaryWriter::getData() const
+{
+	BinaryHeader header;
+	std::memcpy(header.magic, BinaryHeader::binaryMagic, sizeof(header.magic));
+	header.version = BinaryHeader::currentVersion;
+	header.floatSize = sizeof(FloatValue);
+	header.stringCount = std::uint32_t(strings.size());
+	header.stringTableSize = stringTableSize;
+
+	std::vector<char> data(sizeof(header));
+	data.reserve(sizeof(header) + stringTableSize + program.size());
+	std::memcpy(data.data(), &header, sizeof(header));
+	for (const auto* string : strings)
+	{
+		auto length = std::uint32_t(string->size());
+		const auto* lengthBytes = reinterpret_cast<const char*>(&length);
+		data.insert(data.end(), lengthBytes, lengthBytes + sizeof(length));
+		data.insert(data.end(), string->begin(), string->end());
+	}
+	data.insert(data.end(), program.begin(), program.end());
+	return data;
+}
+
+void BinaryWriter::save(const std::string& fileName) const
+{
+	auto data = getData();
+	std::ofstream file{ fileName, std::ios::binary | std::ios::trunc };
+	file.write(data.data(), std::streamsize(data.size()));
+	if (!file)
+		throw InvalidBinaryProgram{ "cannot write file" };
+}
+
+
+BinaryLoader::BinaryLoader(const char* data, std::size_t size) : current(data), end(data + size)
+{
+	auto header = read<BinaryHeader>();
+	if (std::memcmp(header.magic, BinaryHeader::binaryMagic, sizeof(header.magic)) != 0)
+		throw InvalidBinaryProgram{ "wrong file type" };
+	if (header.version != BinaryHeader::currentVersion)
+		throw InvalidBinaryProgram{ "unsupported version" };
+	if (header.floatSize != sizeof(FloatValue))
+		throw InvalidBinaryProgram{ "float precision mismatch" };
+	// the counts come from the file, so they are checked against its size before anything is reserved
+	auto remaining = std::size_t(end - current);
+	if (header.stringTableSize > remaining || std::uint64_t(header.stringCount) * sizeof(std::uint32_t) > header.stringTableSize)
+		throw InvalidBinaryProgram{ "invalid string table" };
+	const auto* stringTableEnd = current + header.stringTableSize;
+	strings.reserve(header.stringCount);
+	for (std::uint32_t i = 0; i < header.stringCount; ++i)
+		strings.push_back(readString());
+	if (current != stringTableEnd)
+		throw InvalidBinaryProgram{ "invalid string table" };
+	symbols.resize(strings.size());
+}
+
+template <typename T> T BinaryLoader::read()
+{
+	if (std::size_t(end - current) < sizeof(T))
+		throw InvalidBinaryProgram{ "unexpected end of data" };
+	T value;
+	std::memcpy(&value, current, sizeof(T));
+	current += sizeof(T);
+	return value;
+}
+
+std::string_view BinaryLoader::readString()
+{
+	auto length = read<std::uint32_t>();
+	if (std::size_t(end - current) < length)
+		throw InvalidBinaryProgram{ "unexpected end of data" };
+	std::string_view value{ current, length };
+	current += length;
+	return value;
+}
+
+void BinaryLoader::serialize(Operation::Ref& obj)
+{
+	auto opType = read<std::uint8_t>();
+	if (opType == noOperation)
+	{
+		obj.reset();
+		return;
+	}
+	if (opType >= std::uint8_t(OperationType::Last))
+		throw InvalidBinaryProgram{ "unknown operation" };
+	obj = Operation::create(OperationType(opType));
+	obj->serialize(*this);
+}
+
+void BinaryLoader::serialize(Value& value)
+{
+	switch (Value::Kind(read<std::uint8_t>()))
+	{
+	case Value::Kind::None:
+		value = Value{};
+		break;
+	case Value::Kind::Int:
+		value = read<IntValue>();
+		break;
+	case Value::Kind::Float:
+		value = read<FloatValue>();
+		break;
+	case Value::Kind::Bool:
+		value = read<std::uint8_t>() != 0;
+		break;
+	case Value::Kind::Object:
+	{
+		auto elementKind = NumericArray::ElementKind(read<std::uint8_t>());
+		if (elementKind != NumericArray::ElementKind::Int && elementKind != NumericArray::ElementKind::Float)
+			throw InvalidBinaryProgram{ "unsupported array kind" };
+		auto size = read<std::uint64_t>();
+		auto elementSize = getElementSize(elementKind);
+		if (size > std::size_t(end - current) / elementSize)
+			throw InvalidBinaryProgram{ "unexpected end of data" };
+		auto array = TypeArray::create(elementKind, std::size_t(size));
+		auto* elements = elementKind == NumericArray::ElementKind::Int
+			? static_cast<void*>(array->get().getInts()) : static_cast<void*>(array->get().getFloats());
+		std::memcpy(elements, current, std::size_t(size) * elementSize);
+		current += std::size_t(size) * elementSize;
+		value = std::move(array);
+		break;
+	}
+	default:
+		throw InvalidBinaryProgram{ "unsupported value kind" };
+	}
+}
+
+void BinaryLoader::serialize(std::string& value)
+{
+	auto stringId = read<std::uint32_t>();
+	if (stringId >= strings.size())
+		throw InvalidBinaryProgram{ "unknown string" };
+	value = strings[stringId];
+}
+
+void BinaryLoader::serialize(Variable& value)
+{
+	// every name is interned once, however often the program uses it
+	auto stringId = read<std::uint32_t>();
+	if (stringId >= strings.size())
+		throw InvalidBinaryProgram{ "unknown string" };
+	if (!symbols[stringId])
+		symbols[stringId] = Symbol{ strings[stringId] };
+	value.name = *symbols[stringId];
+}
+
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& fileName)
+{
+	auto file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw InvalidBinaryProgram{ "cannot open file" };
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		CloseHandle(file);
+		throw InvalidBinaryProgram{ "cannot read file size" };
+	}
+	size = std::size_t(fileSize.QuadPart);
+	if (size > 0)
+	{
+		auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+		{
+			data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(file);
+	if (size > 0 && !data)
+		throw InvalidBinaryProgram{ "cannot map file" };
+}
+
+MappedFile::~MappedFile()
+{
+	if (data)
+		UnmapViewOfFile(data);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& fileName)
+{
+	auto file = open(fileName.c_str(), O_RDONLY);
+	if (file < 0)
+		throw InvalidBinaryProgram{ "cannot open file" };
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0)
+	{
+		close(file);
+		throw InvalidBinaryProgram{ "cannot read file size" };
+	}
+	size = std::size_t(fileStat.st_size);
+	if (size > 0)
+	{
+		auto mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapped != MAP_FAILED)
+			data = static_cast<const char*>(mapped);
+	}
+	close(file);
+	if (size > 0 && !data)
+		throw InvalidBinaryProgram{ "cannot map file" };
+}
+
+MappedFile::~MappedFile()
+{
+	if (data)
+		munmap(const_cast<char*>(data), size);
+}
+
+#endif
+
+const char* MappedFile::getData() const noexcept
+{
+	return data;
+}
+
+std::size_t MappedFile::getSize() const noexcept
+{
+	return size;
+}
+
+
+Operation::Ref loadBinaryProgram(const std::string& fileName)
+{
+	MappedFile file{ fileName };
+	BinaryLoader loader{ file.getData(), file.getSize() };
+	Operation::Ref operation;
+	loader.serialize(operation);
+	return operation;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <CppScript/Serializer.h>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+namespace CppScript
+{
+
+	// Binary program layout (native byte order):
+	//   header:  magic "CSBP", format version, size of FloatValue, string count, string table size
+	//   strings: for every string its byte length followed by the bytes
+	//   program: operations in serialization order, each one its OperationType byte and its fields,
+	//            array literals are their element kind, element count and the raw elements
+	struct BinaryHeader
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint32_t floatSize;
+		std::uint32_t stringCount;
+		std::uint32_t stringTableSize;
+
+		static constexpr char binaryMagic[4] = { 'C', 'S', 'B', 'P' };
+		static constexpr std::uint32_t currentVersion = 1;
+	};
+
+
+	class InvalidBinaryProgram : public std::exception
+	{
+	public:
+		InvalidBinaryProgram(const char* reason) noexcept;
+
+		virtual const char* what() const noexcept override;
+
+	private:
+		std::string message;
+	};
+
+
+	class BinaryWriter : public Serializer
+	{
+	public:
+		virtual void serialize(Operation::Ref& obj) override;
+
+		virtual void serialize(Value& value) override;
+		virtual void serialize(std::string& value) override;
+		virtual void serialize(Variable& value) override;
+
+		std::vector<char> getData() const;
+		void save(const std::string& fileName) const;
+
+	private:
+		template <typename T> void write(const T& value);
+		void writeString(const std::string& value);
+
+		std::vector<char> program;
+		std::vector<const std::string*> strings;
+		std::unordered_map<std::string, std::uint32_t> stringIds;
+		std::uint32_t stringTableSize{ 0 };
+	};
+
+
+	class BinaryLoader : public Serializer
+	{
+	public:
+		BinaryLoader(const char* data, std::size_t size);
+
+		virtual void serialize(Operation::Ref& obj) override;
+
+		virtual void serialize(Value& value) override;
+		virtual void serialize(std::string& value) override;
+		virtual void serialize(Variable& value) override;
+
+	private:
+		template <typename T> T read();
+		std::string_view readString();
+
+		const char* current;
+		const char* end;
+		std::vector<std::string_view> strings;
+		std::vector<std::optional<Symbol>> symbols;
+	};
+
+
+	class MappedFile
+	{
+	public:
+		explicit MappedFile(const std::string& fileName);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		const char* getData() const noexcept;
+		std::size_t getSize() const noexcept;
+
+	private:
+		const char* data{ nullptr };
+		std::size_t size{ 0 };
+	};
+
+
+	Operation::Ref loadBinaryProgram(const std::string& fileName);
+
+}
\ No newline at end of file
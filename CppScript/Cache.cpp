@@ -0,0 +1,191 @@
+#include <CppScript/Cache.h>
+#include <CppScript/Binary.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace CppScript
+{
+
+ProgramCache::ProgramCache(std::size_t memoryBudget, std::string diskDirectory)
+	: budget(memoryBudget), directory(std::move(diskDirectory))
+{}
+
+ProgramCache::Tree ProgramCache::get(const std::string& scriptText)
+{
+	return get(Json::parse(scriptText));
+}
+
+ProgramCache::Tree ProgramCache::get(const Json& script)
+{
+	auto normalized = script.dump();
+	auto key = hash(normalized);
+	if (auto tree = find(key, normalized))
+		return tree;
+
+	// trees are built outside the lock, a concurrent miss on the same script builds it twice
+	std::size_t imageSize = 0;
+	auto operation = loadFromDisk(key, normalized, imageSize);
+	if (operation)
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		++statistics.diskHits;
+	}
+	else
+	{
+		JsonLoader loader{ script };
+		loader.serialize(operation);
+		// the image is only built for the disk, without one the tree is charged about the size of its JSON
+		imageSize = normalized.size();
+		if (!directory.empty())
+		{
+			BinaryWriter writer;
+			writer.serialize(operation);
+			auto image = writer.getData();
+			imageSize = image.size();
+			saveToDisk(key, normalized, image);
+		}
+	}
+
+	Tree tree{ std::move(operation) };
+	auto cost = normalized.size() + imageSize;
+	insert({ key, std::move(normalized), tree, cost });
+	return tree;
+}
+
+ProgramCache::Tree ProgramCache::find(std::uint64_t key, const std::string& normalized)
+{
+	std::lock_guard<std::mutex> lock{ mutex };
+	auto entryPos = index.find(key);
+	if (entryPos == index.end() || entryPos->second->normalized != normalized)
+	{
+		++statistics.misses;
+		return nullptr;
+	}
+	++statistics.hits;
+	entries.splice(entries.begin(), entries, entryPos->second);
+	return entryPos->second->tree;
+}
+
+void ProgramCache::insert(Entry entry)
+{
+	std::lock_guard<std::mutex> lock{ mutex };
+	auto entryPos = index.find(entry.key);
+	if (entryPos != index.end())
+	{
+		memoryUsage -= entryPos->second->cost;
+		entries.erase(entryPos->second);
+		index.erase(entryPos);
+	}
+	if (entry.cost > budget)
+		return;
+	while (memoryUsage + entry.cost > budget)
+	{
+		memoryUsage -= entries.back().cost;
+		index.erase(entries.back().key);
+		entries.pop_back();
+		++statistics.evictions;
+	}
+	memoryUsage += entry.cost;
+	auto key = entry.key;
+	entries.push_front(std::move(entry));
+	index[key] = entries.begin();
+}
+
+ProgramCacheStatistics ProgramCache::getStatistics() const
+{
+	std::lock_guard<std::mutex> lock{ mutex };
+	return statistics;
+}
+
+std::size_t ProgramCache::getMemoryUsage() const
+{
+	std::lock_guard<std::mutex> lock{ mutex };
+	return memoryUsage;
+}
+
+void ProgramCache::clear()
+{
+	std::lock_guard<std::mutex> lock{ mutex };
+	entries.clear();
+	index.clear();
+	memoryUsage = 0;
+}
+
+std::uint64_t ProgramCache::hash(const std::string& normalized) noexcept
+{
+	std::uint64_t value = 14695981039346656037ull;
+	for (auto c : normalized)
+	{
+		value ^= std::uint8_t(c);
+		value *= 1099511628211ull;
+	}
+	return value;
+}
+
+
+// Disk entries are the length of the normalized JSON, the normalized JSON and the binary image,
+// the JSON tells hash collisions apart.
+
+std::string ProgramCache::getDiskPath(std::uint64_t key) const
+{
+	std::ostringstream path;
+	path << directory << '/' << std::hex << std::setw(16) << std::setfill('0') << key << ".csbc";
+	return path.str();
+}
+
+Operation::Ref ProgramCache::loadFromDisk(std::uint64_t key, const std::string& normalized, std::size_t& imageSize) const
+{
+	if (directory.empty())
+		return nullptr;
+	try
+	{
+		MappedFile file{ getDiskPath(key) };
+		std::uint64_t textSize;
+		if (file.getSize() < sizeof(textSize))
+			return nullptr;
+		std::memcpy(&textSize, file.getData(), sizeof(textSize));
+		auto headerSize = sizeof(textSize) + normalized.size();
+		if (textSize != normalized.size() || file.getSize() < headerSize
+			|| std::memcmp(file.getData() + sizeof(textSize), normalized.data(), normalized.size()) != 0)
+			return nullptr;
+		imageSize = file.getSize() - headerSize;
+		BinaryLoader loader{ file.getData() + headerSize, imageSize };
+		Operation::Ref operation;
+		loader.serialize(operation);
+		return operation;
+	}
+	catch (const std::exception&)
+	{
+		// a missing or damaged entry is rebuilt
+		return nullptr;
+	}
+}
+
+void ProgramCache::saveToDisk(std::uint64_t key, const std::string& normalized, const std::vector<char>& image) const
+{
+	// written aside and renamed, so readers never map a partial entry
+	auto path = getDiskPath(key);
+	std::ostringstream temporaryPath;
+	temporaryPath << path << '.' << std::this_thread::get_id();
+	{
+		std::ofstream file{ temporaryPath.str(), std::ios::binary | std::ios::trunc };
+		std::uint64_t textSize = normalized.size();
+		file.write(reinterpret_cast<const char*>(&textSize), sizeof(textSize));
+		file.write(normalized.data(), std::streamsize(normalized.size()));
+		file.write(image.data(), std::streamsize(image.size()));
+		if (!file)
+		{
+			file.close();
+			std::remove(temporaryPath.str().c_str());
+			return;
+		}
+	}
+	if (std::rename(temporaryPath.str().c_str(), path.c_str()) != 0)
+		std::remove(temporaryPath.str().c_str());
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <CppScript/Serializer.h>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace CppScript
+{
+
+	struct ProgramCacheStatistics
+	{
+		std::size_t hits{ 0 };
+		std::size_t misses{ 0 };
+		std::size_t evictions{ 0 };
+		// misses served by the disk tier instead of building the tree
+		std::size_t diskHits{ 0 };
+	};
+
+
+	// Loaded operation trees keyed by their normalized JSON (compact, object keys sorted), so scripts
+	// differing only in layout share one tree. The trees are shared between threads, so their variables
+	// are left unresolved.
+	// The least recently used trees are evicted once the budget is exceeded, every tree is charged its
+	// normalized JSON and its binary image, or the JSON size again when no image is built for the disk.
+	// With a directory given, trees are also stored there in the binary format and loaded from it on
+	// misses, e.g. after a restart.
+	class ProgramCache
+	{
+	public:
+		using Tree = std::shared_ptr<const Operation>;
+
+		explicit ProgramCache(std::size_t memoryBudget, std::string diskDirectory = {});
+
+		Tree get(const Json& script);
+		Tree get(const std::string& scriptText);
+
+		ProgramCacheStatistics getStatistics() const;
+		std::size_t getMemoryUsage() const;
+		void clear();
+
+		// FNV-1a of the normalized JSON
+		static std::uint64_t hash(const std::string& normalized) noexcept;
+
+	private:
+		struct Entry
+		{
+			std::uint64_t key;
+			std::string normalized;
+			Tree tree;
+			std::size_t cost;
+		};
+
+		Tree find(std::uint64_t key, const std::string& normalized);
+		void insert(Entry entry);
+		std::string getDiskPath(std::uint64_t key) const;
+		Operation::Ref loadFromDisk(std::uint64_t key, const std::string& normalized, std::size_t& imageSize) const;
+		void saveToDisk(std::uint64_t key, const std::string& normalized, const std::vector<char>& image) const;
+
+		const std::size_t budget;
+		const std::string directory;
+		mutable std::mutex mutex;
+		std::list<Entry> entries;
+		std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index;
+		std::size_t memoryUsage{ 0 };
+		ProgramCacheStatistics statistics;
+	};
+
+}
\ No newline at end of file
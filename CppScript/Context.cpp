@@ -1,17 +1,170 @@
 #include <CppScript/Context.h>
 #include <CppScript/TypeWrapper.h>
+#include <algorithm>
+#include <stdexcept>
 
 namespace CppScript
 {
 
-TypeBase::Ref Context::get(const std::string& id)
+Context::Context(const Context& other)
+	: slots(other.slots), versions(other.versions), clock(other.clock)
 {
-	return data.at(id);
+	for (const auto& chunk : other.chunks)
+	{
+		chunks.push_back(std::make_unique<Value[]>(chunkSize));
+		std::copy_n(chunk.get(), chunkSize, chunks.back().get());
+	}
 }
 
-TypeBase::Ref Context::set(const std::string& id, TypeBase::Ref value)
+Context& Context::operator=(const Context& other)
 {
-	return data[id] = value;
+	if (this != &other)
+		*this = Context{ other };
+	return *this;
+}
+
+Context::Slot Context::getSlot(Symbol id)
+{
+	auto slotPos = slots.try_emplace(id, versions.size());
+	if (slotPos.second)
+	{
+		if (versions.size() == chunks.size() * chunkSize)
+			chunks.push_back(std::make_unique<Value[]>(chunkSize));
+		versions.push_back(0);
+	}
+	return slotPos.first->second;
+}
+
+Value& Context::get(Symbol id)
+{
+	return get(slots.at(id));
+}
+
+Value& Context::set(Symbol id, Value value)
+{
+	return set(getSlot(id), std::move(value));
+}
+
+Value& Context::get(Slot slot)
+{
+	if (slot >= versions.size())
+		throw std::out_of_range{ "Context variable is not set" };
+	auto& value = at(slot);
+	if (value.isNone())
+		throw std::out_of_range{ "Context variable is not set" };
+	return value;
+}
+
+Value& Context::set(Slot slot, Value value)
+{
+	if (slot >= versions.size())
+		throw std::out_of_range{ "Context slot is not bound" };
+	changed(slot);
+	return at(slot) = std::move(value);
+}
+
+Value* Context::getStorage(Slot slot) noexcept
+{
+	return slot < versions.size() ? &at(slot) : nullptr;
+}
+
+Value& Context::get(const Variable& variable)
+{
+	if (variable.slot == unresolved)
+		return get(slots.at(variable.name));
+	return get(variable.slot);
+}
+
+Value& Context::set(const Variable& variable, Value value)
+{
+	if (variable.slot == unresolved)
+		return set(getSlot(variable.name), std::move(value));
+	return set(variable.slot, std::move(value));
+}
+
+Value* Context::find(const Variable& variable) noexcept
+{
+	auto slot = variable.slot;
+	if (slot == unresolved)
+	{
+		auto slotPos = slots.find(variable.name);
+		if (slotPos == slots.end())
+			return nullptr;
+		slot = slotPos->second;
+	}
+	else if (slot >= versions.size())
+		return nullptr;
+	auto& value = at(slot);
+	return value.isNone() ? nullptr : &value;
+}
+
+Context::Slot Context::findSlot(const Variable& variable) const noexcept
+{
+	if (variable.slot != unresolved)
+		return variable.slot;
+	auto slotPos = slots.find(variable.name);
+	return slotPos != slots.end() ? slotPos->second : unresolved;
+}
+
+Context::Version Context::getVersion(Slot slot) const noexcept
+{
+	return slot < versions.size() ? versions[slot] : 0;
+}
+
+Context::Version Context::getClock() const noexcept
+{
+	return clock;
+}
+
+void Context::touch(Slot slot)
+{
+	if (slot < versions.size())
+		changed(slot);
+}
+
+void Context::touch(const Value& storage)
+{
+	// pointers into the chunks are compared as integers, values stored elsewhere are not ordered with them
+	auto address = reinterpret_cast<std::uintptr_t>(&storage);
+	for (std::size_t i = 0; i < chunks.size(); ++i)
+	{
+		auto begin = reinterpret_cast<std::uintptr_t>(chunks[i].get());
+		if (address >= begin && address < begin + chunkSize * sizeof(Value))
+		{
+			auto slot = i * chunkSize + (address - begin) / sizeof(Value);
+			if (slot < versions.size())
+				changed(slot);
+			return;
+		}
+	}
+}
+
+void Context::setChangeLog(std::vector<Slot>* log) noexcept
+{
+	changeLog = log;
+	logStart = clock;
+}
+
+void Context::changed(Slot slot)
+{
+	if (changeLog && versions[slot] <= logStart)
+		changeLog->push_back(slot);
+	versions[slot] = ++clock;
+}
+
+std::vector<Symbol> Context::getNames() const
+{
+	std::vector<Symbol> names;
+	names.reserve(slots.size());
+	for (const auto& slot : slots)
+		names.push_back(slot.first);
+	return names;
+}
+
+Context Context::clone() const
+{
+	// the change log is not copied
+	return *this;
 }
 
 
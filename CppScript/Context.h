@@ -1,20 +1,98 @@
 #pragma once
 
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
+#include <limits>
+#include <memory>
 #include <CppScript/Base.h>
+#include <CppScript/Value.h>
+#include <CppScript/Symbol.h>
 #include <CppScript/TypeWrapper.h>
-#include <CppScript/Operations.h>
 
 namespace CppScript
 {
+	class Variable;
+
 	class Context
 	{
 	public:
-		TypeBase::Ref get(const std::string& id);
-		TypeBase::Ref set(const std::string& id, TypeBase::Ref value);
+		// Values are stored in chunks that never move, so references returned by get/set stay valid
+		// while new names are bound, e.g. by an unresolved tree between reading and using an operand.
+		// Slots belong to the context that bound them: a tree resolved against one context may only run
+		// on contexts binding the same names to the same slots, such as its copies. Slots the context
+		// does not have are reported like unset variables.
+		using Slot = std::size_t;
+		static constexpr Slot unresolved = std::numeric_limits<Slot>::max();
+		// Every variable carries the clock of its last change by set or touch. Changes made in place
+		// through references returned by get, find or getStorage are only seen once touched.
+		using Version = std::uint64_t;
+
+		Context() = default;
+		Context(const Context& other);
+		Context(Context&& other) = default;
+		Context& operator=(const Context& other);
+		Context& operator=(Context&& other) = default;
+
+		Slot getSlot(Symbol id);
+
+		Value& get(Symbol id);
+		Value& set(Symbol id, Value value);
+
+		Value& get(Slot slot);
+		Value& set(Slot slot, Value value);
+		// stored value of the slot even when it is not set, null for a slot the context does not have
+		Value* getStorage(Slot slot) noexcept;
+
+		Value& get(const Variable& variable);
+		Value& set(const Variable& variable, Value value);
+		// the value of a set variable, null for unknown or unset ones
+		Value* find(const Variable& variable) noexcept;
+		// slot of the variable, unresolved for names the context does not have
+		Slot findSlot(const Variable& variable) const noexcept;
+
+		Version getVersion(Slot slot) const noexcept;
+		Version getClock() const noexcept;
+		void touch(Slot slot);
+		// touches the variable stored in the value, values stored elsewhere are left alone
+		void touch(const Value& storage);
+		// slots changed by set and touch are appended to the log on their first change after it is set,
+		// null turns logging off
+		void setChangeLog(std::vector<Slot>* log) noexcept;
+
+		std::vector<Symbol> getNames() const;
+		// Copy sharing the objects of its values, changing one context copies the changed objects
+		// (see Value::makeUnique) and leaves the other as it was.
+		Context clone() const;
 
 	private:
-		std::unordered_map<std::string, TypeBase::Ref> data;
+		static constexpr std::size_t chunkSize = 64;
+
+		Value& at(Slot slot) noexcept
+		{
+			return chunks[slot / chunkSize][slot % chunkSize];
+		}
+
+		void changed(Slot slot);
+
+		std::unordered_map<Symbol, Slot> slots;
+		std::vector<std::unique_ptr<Value[]>> chunks;
+		std::vector<Version> versions;
+		Version clock{ 0 };
+		std::vector<Slot>* changeLog{ nullptr };
+		Version logStart{ 0 };
+	};
+
+
+	class Variable
+	{
+	public:
+		Variable() = default;
+		Variable(Symbol varName) noexcept : name(varName)
+		{}
+
+		Symbol name;
+		Context::Slot slot{ Context::unresolved };
 	};
 
 
@@ -0,0 +1,187 @@
+#include <CppScript/Dispatch.h>
+#include <CppScript/NumericArray.h>
+#include <functional>
+
+namespace CppScript
+{
+
+class BasicKernels
+{
+public:
+	static Expected<Value*> addIntInt(Value& destination, const Value& source)
+	{
+		destination.intValue += source.intValue;
+		return &destination;
+	}
+
+	static Expected<Value*> addFloatFloat(Value& destination, const Value& source)
+	{
+		destination.floatValue += source.floatValue;
+		return &destination;
+	}
+
+	static Expected<Value*> addFloatInt(Value& destination, const Value& source)
+	{
+		destination.floatValue += FloatValue(source.intValue);
+		return &destination;
+	}
+
+	static NumericArray& getArray(const Value& value)
+	{
+		return static_cast<TypeArray&>(*value.object).get();
+	}
+
+	static Expected<Value*> addArrayArray(Value& destination, const Value& source)
+	{
+		if (auto error = getArray(destination).getAdditionError(getArray(source)))
+			return error;
+		destination.makeUnique();
+		getArray(destination) += getArray(source);
+		return &destination;
+	}
+
+	static Expected<Value*> addArrayInt(Value& destination, const Value& source)
+	{
+		destination.makeUnique();
+		getArray(destination) += source.intValue;
+		return &destination;
+	}
+
+	static Expected<Value*> addArrayFloat(Value& destination, const Value& source)
+	{
+		if (auto error = getArray(destination).getAdditionError(NumericArray::ElementKind::Float))
+			return error;
+		destination.makeUnique();
+		getArray(destination) += source.floatValue;
+		return &destination;
+	}
+
+	static Expected<Value*> addOther(Value& destination, const Value& source)
+	{
+		switch (destination.kind)
+		{
+		case Value::Kind::Int:
+			return ExecutionError{ ErrorCode::InvalidTypeCast, source.getId().getName(), TypeInt::id().getName() };
+		case Value::Kind::Float:
+			return ExecutionError{ ErrorCode::InvalidTypeCast, source.getId().getName(), TypeFloat::id().getName() };
+		case Value::Kind::Object:
+			// none has no object to box
+			if (source.kind == Value::Kind::None)
+				return ExecutionError{ ErrorCode::InvalidTypeCast, source.getId().getName(), destination.getId().getName() };
+			// other object types report their errors by exceptions
+			try
+			{
+				auto result = (*destination.object) += (source.kind == Value::Kind::Object ? *source.object : *source.box());
+				if (result != destination.object)
+					destination = Value{ std::move(result) };
+				return &destination;
+			}
+			catch (const ScriptException& exception)
+			{
+				return exception.getError();
+			}
+		default:
+			return ExecutionError{ ErrorCode::InvalidOperation, destination.getId().getName(), "Addition" };
+		}
+	}
+
+
+	template <typename Compare> static bool compareIntInt(const Value& left, const Value& right)
+	{
+		return Compare{}(left.intValue, right.intValue);
+	}
+
+	template <typename Compare> static bool compareIntFloat(const Value& left, const Value& right)
+	{
+		return Compare{}(FloatValue(left.intValue), right.floatValue);
+	}
+
+	template <typename Compare> static bool compareFloatInt(const Value& left, const Value& right)
+	{
+		return Compare{}(left.floatValue, FloatValue(right.intValue));
+	}
+
+	template <typename Compare> static bool compareFloatFloat(const Value& left, const Value& right)
+	{
+		return Compare{}(left.floatValue, right.floatValue);
+	}
+
+	template <typename Compare> static bool compareBoolBool(const Value& left, const Value& right)
+	{
+		return Compare{}(left.boolValue, right.boolValue);
+	}
+
+	template <typename Compare> static bool compareArrayArray(const Value& left, const Value& right)
+	{
+		return Compare{}(getArray(left), getArray(right));
+	}
+
+	template <typename Compare> static bool compareOther(const Value& left, const Value& right)
+	{
+		constexpr auto opName = std::is_same_v<Compare, std::equal_to<>> ? "Equals" : "Less";
+		switch (left.kind)
+		{
+		case Value::Kind::Int:
+			right.throwInvalidCast(TypeInt::id());
+		case Value::Kind::Float:
+			right.throwInvalidCast(TypeFloat::id());
+		case Value::Kind::Bool:
+			right.throwInvalidCast(TypeBool::id());
+		case Value::Kind::Object:
+		{
+			if (right.kind == Value::Kind::None)
+				right.throwInvalidCast(left.getId());
+			const auto& rightObject = right.kind == Value::Kind::Object ? right.object : right.box();
+			if constexpr (std::is_same_v<Compare, std::equal_to<>>)
+				return (*left.object) == (*rightObject);
+			else
+				return (*left.object) < (*rightObject);
+		}
+		default:
+			throw InvalidOperation{ left.getId().getName(), opName };
+		}
+	}
+
+	template <typename Compare> static DispatchTable<CompareKernel> makeCompareTable()
+	{
+		DispatchTable<CompareKernel> table{ compareOther<Compare> };
+		table.set(TypeInt::id(), TypeInt::id(), compareIntInt<Compare>);
+		table.set(TypeInt::id(), TypeFloat::id(), compareIntFloat<Compare>);
+		table.set(TypeFloat::id(), TypeInt::id(), compareFloatInt<Compare>);
+		table.set(TypeFloat::id(), TypeFloat::id(), compareFloatFloat<Compare>);
+		table.set(TypeBool::id(), TypeBool::id(), compareBoolBool<Compare>);
+		table.set(TypeArray::id(), TypeArray::id(), compareArrayArray<Compare>);
+		return table;
+	}
+};
+
+
+DispatchTable<AddKernel>& OperatorTables::getAdd()
+{
+	static DispatchTable<AddKernel> table = []()
+	{
+		DispatchTable<AddKernel> table{ BasicKernels::addOther };
+		table.set(TypeInt::id(), TypeInt::id(), BasicKernels::addIntInt);
+		table.set(TypeFloat::id(), TypeFloat::id(), BasicKernels::addFloatFloat);
+		table.set(TypeFloat::id(), TypeInt::id(), BasicKernels::addFloatInt);
+		table.set(TypeArray::id(), TypeArray::id(), BasicKernels::addArrayArray);
+		table.set(TypeArray::id(), TypeInt::id(), BasicKernels::addArrayInt);
+		table.set(TypeArray::id(), TypeFloat::id(), BasicKernels::addArrayFloat);
+		return table;
+	}();
+	return table;
+}
+
+DispatchTable<CompareKernel>& OperatorTables::getEqual()
+{
+	static auto table = BasicKernels::makeCompareTable<std::equal_to<>>();
+	return table;
+}
+
+DispatchTable<CompareKernel>& OperatorTables::getLess()
+{
+	static auto table = BasicKernels::makeCompareTable<std::less<>>();
+	return table;
+}
+
+}
\ No newline at end of file
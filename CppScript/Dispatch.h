@@ -0,0 +1,62 @@
+#pragma once
+
+#include <CppScript/Value.h>
+#include <algorithm>
+#include <vector>
+
+
+namespace CppScript
+{
+
+	// Square table of kernels indexed by the dense type indices of both operands. Pairs without
+	// a registered kernel use the fallback. Kernels have to be registered before scripts run.
+	template <typename Kernel> class DispatchTable
+	{
+	public:
+		explicit DispatchTable(Kernel fallbackKernel) noexcept : fallback(fallbackKernel)
+		{}
+
+		void set(const TypeIdBase& left, const TypeIdBase& right, Kernel kernel)
+		{
+			auto requiredSize = std::size_t(std::max(left.getIndex(), right.getIndex())) + 1;
+			if (requiredSize > size)
+				resize(requiredSize);
+			kernels[left.getIndex() * size + right.getIndex()] = kernel;
+		}
+
+		Kernel get(std::uint32_t left, std::uint32_t right) const noexcept
+		{
+			if (left < size && right < size)
+				return kernels[left * size + right];
+			return fallback;
+		}
+
+	private:
+		void resize(std::size_t newSize)
+		{
+			std::vector<Kernel> newKernels(newSize * newSize, fallback);
+			for (std::size_t left = 0; left < size; ++left)
+				std::copy_n(kernels.begin() + left * size, size, newKernels.begin() + left * newSize);
+			kernels.swap(newKernels);
+			size = newSize;
+		}
+
+		Kernel fallback;
+		std::size_t size{ 0 };
+		std::vector<Kernel> kernels;
+	};
+
+
+	using AddKernel = Expected<Value*> (*)(Value& destination, const Value& source);
+	using CompareKernel = bool (*)(const Value& left, const Value& right);
+
+	// Binary operator tables of Value, prefilled with the kernels of the basic types.
+	class OperatorTables
+	{
+	public:
+		static DispatchTable<AddKernel>& getAdd();
+		static DispatchTable<CompareKernel>& getEqual();
+		static DispatchTable<CompareKernel>& getLess();
+	};
+
+}
\ No newline at end of file
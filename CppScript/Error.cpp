@@ -0,0 +1,53 @@
+#include <CppScript/Types.h>
+#include <stdexcept>
+
+namespace CppScript
+{
+
+std::string ExecutionError::getMessage() const
+{
+	switch (code)
+	{
+	case ErrorCode::InvalidTypeCast:
+		return std::string{ "Cannot cast from: " } + firstName + " to: " + secondName;
+	case ErrorCode::InvalidOperation:
+		return std::string{ "Type: " } + firstName + ": " + secondName + " is not supported";
+	case ErrorCode::UnsetVariable:
+		return std::string{ "Context variable is not set: " } + firstName;
+	default:
+		return {};
+	}
+}
+
+void ExecutionError::raise() const
+{
+	switch (code)
+	{
+	case ErrorCode::InvalidTypeCast:
+		throw InvalidTypeCast{ firstName, secondName };
+	case ErrorCode::InvalidOperation:
+		throw InvalidOperation{ firstName, secondName };
+	case ErrorCode::UnsetVariable:
+		throw std::out_of_range{ getMessage() };
+	default:
+		throw std::logic_error{ "no execution error to raise" };
+	}
+}
+
+
+const char* ScriptException::what() const noexcept
+{
+	// exceptions thrown and caught without reading the message never format it
+	if (message.empty())
+		try
+		{
+			message = error.getMessage();
+		}
+		catch (const std::bad_alloc&)
+		{
+			return "script error";
+		}
+	return message.c_str();
+}
+
+}
\ No newline at end of file
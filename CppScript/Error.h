@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+
+namespace CppScript
+{
+
+	enum class ErrorCode : std::uint8_t
+	{
+		None,
+		InvalidTypeCast,	// names: source type, target type
+		InvalidOperation,	// names: type, operation
+		UnsetVariable		// names: variable
+	};
+
+
+	// Script error as a code and the static names describing it, so that reporting one allocates
+	// nothing; the message is only formatted when asked for.
+	class ExecutionError
+	{
+	public:
+		constexpr ExecutionError() noexcept = default;
+		constexpr ExecutionError(ErrorCode errorCode, const char* first, const char* second = "") noexcept
+			: code(errorCode), firstName(first), secondName(second)
+		{}
+
+		explicit operator bool() const noexcept
+		{
+			return code != ErrorCode::None;
+		}
+
+		ErrorCode getCode() const noexcept
+		{
+			return code;
+		}
+
+		std::string getMessage() const;
+		// throws the exception the throwing API reports this error with
+		[[noreturn]] void raise() const;
+
+	private:
+		ErrorCode code{ ErrorCode::None };
+		const char* firstName{ "" };
+		const char* secondName{ "" };
+	};
+
+
+	// Base of the exceptions reporting an ExecutionError, the message is formatted on the first what().
+	class ScriptException : public std::exception
+	{
+	public:
+		explicit ScriptException(ExecutionError err) noexcept : error(err)
+		{}
+
+		const ExecutionError& getError() const noexcept
+		{
+			return error;
+		}
+
+		virtual const char* what() const noexcept override;
+
+	private:
+		ExecutionError error;
+		mutable std::string message;
+	};
+
+
+	// Either a value or the error that prevented it.
+	template <typename T> class Expected
+	{
+	public:
+		Expected(T val) noexcept(std::is_nothrow_move_constructible_v<T>) : value(std::move(val))
+		{}
+		Expected(ExecutionError err) noexcept : error(err)
+		{}
+
+		explicit operator bool() const noexcept
+		{
+			return !error;
+		}
+
+		const ExecutionError& getError() const noexcept
+		{
+			return error;
+		}
+
+		T& operator*() noexcept
+		{
+			return value;
+		}
+
+		const T& operator*() const noexcept
+		{
+			return value;
+		}
+
+		T* operator->() noexcept
+		{
+			return &value;
+		}
+
+		const T* operator->() const noexcept
+		{
+			return &value;
+		}
+
+		// the value, the error is thrown
+		T& get()
+		{
+			if (error)
+				error.raise();
+			return value;
+		}
+
+	private:
+		T value{};
+		ExecutionError error;
+	};
+
+}
\ No newline at end of file
@@ -1,9 +1,76 @@
 #include <CppScript/Execution.h>
+#include <CppScript/Jit.h>
+#include <algorithm>
+#include <mutex>
 
 
 namespace CppScript
 {
 
+struct Program::NativeCache
+{
+	std::once_flag compiled;
+	std::unique_ptr<NativeCode> code;
+};
+
+Program::Program() : nativeCache(std::make_shared<NativeCache>())
+{}
+
+Program::Program(const Operation& operation) : Program()
+{
+	Compiler compiler{ *this };
+	compiler.compile(operation, 0);
+}
+
+const NativeCode* Program::getNativeCode() const
+{
+	std::call_once(nativeCache->compiled, [this]() { nativeCache->code = NativeCode::compile(*this); });
+	return nativeCache->code.get();
+}
+
+
+Compiler::Compiler(Program& prog) : program(prog)
+{}
+
+Compiler::Register Compiler::compile(const Operation& operation, Register target)
+{
+	auto parentTarget = currentTarget;
+	currentTarget = target;
+	program.registerCount = std::max(program.registerCount, std::size_t(target) + 1);
+	operation.compile(*this);
+	currentTarget = parentTarget;
+	return target;
+}
+
+Compiler::Register Compiler::getTarget() const
+{
+	return currentTarget;
+}
+
+void Compiler::emit(OpCode code, Register target, std::uint32_t operand)
+{
+	program.code.push_back({ code, target, operand });
+}
+
+std::uint32_t Compiler::addConstant(const Value& value)
+{
+	program.constants.push_back(&value);
+	return std::uint32_t(program.constants.size() - 1);
+}
+
+std::uint32_t Compiler::addVariable(const Variable& variable)
+{
+	program.variables.push_back(variable);
+	return std::uint32_t(program.variables.size() - 1);
+}
+
+std::uint32_t Compiler::addOperation(const Operation& operation)
+{
+	program.operations.push_back(&operation);
+	return std::uint32_t(program.operations.size() - 1);
+}
+
+
 Executor::Executor(Context& cntx) : context(cntx)
 {}
 
@@ -12,9 +79,154 @@ Context& Executor::getContext()
 	return context;
 }
 
-/*Element::Ref ForLoop::execute() const
+Value& Executor::execute(const Operation& operation)
 {
+	return *tryExecute(operation).get();
+}
+
+Value& Executor::execute(const Program& program)
+{
+	return *tryExecute(program).get();
+}
 
-}*/
+Expected<Value*> Executor::tryExecute(const Operation& operation)
+{
+	temporaryCount = 0;
+	return operation.tryExecute(*this);
+}
+
+Expected<Value*> Executor::tryExecute(const Program& program)
+{
+	if (registers.size() < program.registerCount)
+	{
+		registers.resize(program.registerCount);
+		registerValues.resize(program.registerCount);
+		nativeScratch.resize(program.registerCount);
+	}
+	temporaryCount = 0;
+	if (jitEnabled)
+		if (const auto* native = program.getNativeCode())
+		{
+			if (auto* result = native->run(context, nativeVariables, nativeScratch.data(), registerValues))
+			{
+				++jitStatistics.nativeRuns;
+				return result;
+			}
+			++jitStatistics.guardFailures;
+		}
+	auto* reg = registers.data();
+	for (const auto& instruction : program.code)
+	{
+		switch (instruction.code)
+		{
+		case OpCode::Value:
+			registerValues[instruction.target] = *program.constants[instruction.operand];
+			reg[instruction.target] = &registerValues[instruction.target];
+			break;
+		case OpCode::Read:
+		{
+			const auto& variable = program.variables[instruction.operand];
+			reg[instruction.target] = context.find(variable);
+			if (!reg[instruction.target])
+				return ExecutionError{ ErrorCode::UnsetVariable, variable.name.str().c_str() };
+			break;
+		}
+		case OpCode::Assign:
+			reg[instruction.target] = &context.set(program.variables[instruction.operand], *reg[instruction.target]);
+			break;
+		case OpCode::Clone:
+			registerValues[instruction.target] = *reg[instruction.operand];
+			reg[instruction.target] = &registerValues[instruction.target];
+			break;
+		case OpCode::Add:
+		{
+			auto result = reg[instruction.target]->tryAdd(*reg[instruction.operand]);
+			if (!result)
+				return result;
+			recordChange(*reg[instruction.target]);
+			break;
+		}
+		case OpCode::Execute:
+		{
+			auto result = program.operations[instruction.operand]->tryExecute(*this);
+			if (!result)
+				return result;
+			reg[instruction.target] = *result;
+			break;
+		}
+		}
+	}
+	return reg[0];
+}
+
+void Executor::setJitEnabled(bool enabled) noexcept
+{
+	jitEnabled = enabled;
+}
+
+bool Executor::isJitEnabled() const noexcept
+{
+	return jitEnabled;
+}
+
+const JitStatistics& Executor::getJitStatistics() const noexcept
+{
+	return jitStatistics;
+}
+
+void Executor::setProfiler(Profiler* prof) noexcept
+{
+	profiler = prof;
+}
+
+Profiler* Executor::getProfiler() const noexcept
+{
+	return profiler;
+}
+
+void Executor::setRecord(ExecutionRecord* rec)
+{
+	record = rec;
+	if (record)
+	{
+		record->start = context.getClock();
+		++readGeneration;
+	}
+	context.setChangeLog(record ? &record->changes : nullptr);
+}
+
+void Executor::addRead(const Variable& variable)
+{
+	// only the first read of a variable counts, e.g. loop bodies read the same ones many times
+	auto slot = context.findSlot(variable);
+	if (slot == Context::unresolved)
+		return;
+	if (slot >= readGenerations.size())
+		readGenerations.resize(slot + 1, 0);
+	if (readGenerations[slot] == readGeneration)
+		return;
+	readGenerations[slot] = readGeneration;
+	if (context.getVersion(slot) <= record->start)
+		record->reads.push_back(slot);
+}
+
+Value& Executor::makeTemporary(Value value)
+{
+	if (temporaryCount == temporaries.size())
+		temporaries.push_back(std::move(value));
+	else
+		temporaries[temporaryCount] = std::move(value);
+	return temporaries[temporaryCount++];
+}
+
+std::size_t Executor::getTemporaryMark() const noexcept
+{
+	return temporaryCount;
+}
+
+void Executor::releaseTemporaries(std::size_t mark) noexcept
+{
+	temporaryCount = mark;
+}
 
 }
\ No newline at end of file
@@ -3,37 +3,154 @@
 #include <CppScript/Base.h>
 #include <CppScript/Operations.h>
 #include <CppScript/Context.h>
+#include <cstdint>
+#include <deque>
+#include <memory>
 
 namespace CppScript
 {
 
-class Executor
+class NativeCode;
+class Profiler;
+
+enum class OpCode : std::uint8_t
+{
+	Value,
+	Read,
+	Assign,
+	Clone,
+	Add,
+	Execute		// operation without bytecode form, run as a tree
+};
+
+struct Instruction
+{
+	OpCode code;
+	std::uint32_t target;
+	std::uint32_t operand;
+};
+
+
+class Program
 {
 public:
-	explicit Executor(Context& cntx);
-	virtual ~Executor() = default;
+	Program();
+	explicit Program(const Operation& operation);
 
-	Context& getContext();
+	// native code compiled once on the first request, null when the program cannot be compiled;
+	// the program must be complete and its variables resolved by then
+	const NativeCode* getNativeCode() const;
+
+	std::vector<Instruction> code;
+	std::vector<const Value*> constants;
+	std::vector<Variable> variables;
+	std::vector<const Operation*> operations;
+	std::size_t registerCount{ 0 };
 
 private:
-	Context& context;
+	struct NativeCache;
+	std::shared_ptr<NativeCache> nativeCache;
+};
+
+
+class Compiler
+{
+public:
+	using Register = std::uint32_t;
+
+	explicit Compiler(Program& prog);
+
+	Register compile(const Operation& operation, Register target);
+	Register getTarget() const;
+
+	void emit(OpCode code, Register target, std::uint32_t operand);
+	std::uint32_t addConstant(const Value& value);
+	std::uint32_t addVariable(const Variable& variable);
+	std::uint32_t addOperation(const Operation& operation);
+
+private:
+	Program& program;
+	Register currentTarget{ 0 };
+};
+
+
+// Variables read by the operations run while recording and the variables they changed.
+struct ExecutionRecord
+{
+	// clock of the context when recording started
+	Context::Version start{ 0 };
+	// variables read before the recorded run changed them
+	std::vector<Context::Slot> reads;
+	std::vector<Context::Slot> changes;
 };
 
 
-class ForLoopExecuter : public Executor
+struct JitStatistics
+{
+	std::size_t nativeRuns{ 0 };
+	std::size_t guardFailures{ 0 };
+};
+
+
+class Executor
 {
 public:
-	explicit ForLoopExecuter(Executor& parent);
-	/*void accept(VisitorOld& visitor) override
+	explicit Executor(Context& cntx);
+	virtual ~Executor() = default;
+
+	Context& getContext();
+
+	Value& execute(const Operation& operation);
+	Value& execute(const Program& program);
+	// script errors are returned instead of thrown, see Operation::tryExecute
+	Expected<Value*> tryExecute(const Operation& operation);
+	Expected<Value*> tryExecute(const Program& program);
+
+	// programs run as native code when enabled and the platform supports it, falling back to the interpreter
+	void setJitEnabled(bool enabled) noexcept;
+	bool isJitEnabled() const noexcept;
+	const JitStatistics& getJitStatistics() const noexcept;
+
+	// measures instrumented operations (see Profiler) while set, null turns profiling off
+	void setProfiler(Profiler* prof) noexcept;
+	Profiler* getProfiler() const noexcept;
+
+	// Operations report their reads and changes to the record while one is set, changes made in place
+	// are only versioned by the context then (see Context::touch). Null stops recording.
+	void setRecord(ExecutionRecord* rec);
+	void recordRead(const Variable& variable)
+	{
+		if (record)
+			addRead(variable);
+	}
+	void recordChange(const Value& value)
 	{
-		visitor.visit(*this);
-	}*/
+		if (record)
+			context.touch(value);
+	}
 
-	//Element::Ref execute() const override;
+	Value& makeTemporary(Value value);
+	// temporaries made after the mark may be reused once released, e.g. by every loop iteration
+	std::size_t getTemporaryMark() const noexcept;
+	void releaseTemporaries(std::size_t mark) noexcept;
 
-protected:
+private:
+	void addRead(const Variable& variable);
 
-	//Iterator& iterator;
+	Context& context;
+	std::deque<Value> temporaries;
+	std::size_t temporaryCount{ 0 };
+	std::vector<Value*> registers;
+	std::vector<Value> registerValues;
+	std::vector<IntValue> nativeScratch;
+	std::vector<Value*> nativeVariables;
+	bool jitEnabled{ false };
+	JitStatistics jitStatistics;
+	Profiler* profiler{ nullptr };
+	ExecutionRecord* record{ nullptr };
+	// generation of the record in which each slot was last read
+	std::vector<std::uint32_t> readGenerations;
+	std::uint32_t readGeneration{ 0 };
 };
 
 }
@@ -0,0 +1,132 @@
+#include <CppScript/Incremental.h>
+#include <algorithm>
+
+namespace CppScript
+{
+
+IncrementalRunner::IncrementalRunner(Context& cntx) : context(cntx), executor(cntx)
+{}
+
+IncrementalRunner::~IncrementalRunner()
+{
+	context.setChangeLog(nullptr);
+}
+
+void IncrementalRunner::add(const Operation& statement)
+{
+	statements.push_back({ &statement, {}, {} });
+	pending.insert(statements.size() - 1);
+}
+
+void IncrementalRunner::invalidate()
+{
+	for (std::size_t i = 0; i < statements.size(); ++i)
+		pending.insert(i);
+}
+
+void IncrementalRunner::run()
+{
+	if (auto error = tryRun())
+		error.raise();
+}
+
+ExecutionError IncrementalRunner::tryRun()
+{
+	context.setChangeLog(nullptr);
+	for (auto slot : changeLog)
+		changed(slot, nullptr);
+	changeLog.clear();
+
+	// statements made pending by later ones wait for the next run
+	auto executedCount = statistics.executed;
+	ExecutionError error;
+	try
+	{
+		for (auto next = pending.begin(); next != pending.end() && !error; )
+		{
+			auto index = *next;
+			pending.erase(next);
+			error = execute(index);
+			next = pending.upper_bound(index);
+		}
+	}
+	catch (...)
+	{
+		context.setChangeLog(&changeLog);
+		throw;
+	}
+	statistics.skipped += statements.size() - (statistics.executed - executedCount);
+	context.setChangeLog(&changeLog);
+	return error;
+}
+
+const IncrementalStatistics& IncrementalRunner::getStatistics() const noexcept
+{
+	return statistics;
+}
+
+ExecutionError IncrementalRunner::execute(std::size_t index)
+{
+	++statistics.executed;
+	record.reads.clear();
+	record.changes.clear();
+	executor.setRecord(&record);
+	Expected<Value*> result{ nullptr };
+	try
+	{
+		result = executor.tryExecute(*statements[index].operation);
+	}
+	catch (...)
+	{
+		executor.setRecord(nullptr);
+		pending.insert(index);
+		throw;
+	}
+	executor.setRecord(nullptr);
+
+	setDependencies(index, false);
+	auto& statement = statements[index];
+	statement.reads = record.reads;
+	statement.changes = record.changes;
+	setDependencies(index, true);
+	for (auto slot : statement.changes)
+		changed(slot, &statement);
+	if (!result)
+	{
+		pending.insert(index);
+		return result.getError();
+	}
+	return {};
+}
+
+void IncrementalRunner::setDependencies(std::size_t index, bool isDependent)
+{
+	for (const auto* slots : { &statements[index].reads, &statements[index].changes })
+		for (auto slot : *slots)
+		{
+			if (slot >= dependents.size())
+				dependents.resize(slot + 1);
+			auto& slotDependents = dependents[slot];
+			auto dependentPos = std::find(slotDependents.begin(), slotDependents.end(), index);
+			if (isDependent && dependentPos == slotDependents.end())
+				slotDependents.push_back(index);
+			else if (!isDependent && dependentPos != slotDependents.end())
+				slotDependents.erase(dependentPos);
+		}
+}
+
+void IncrementalRunner::changed(Context::Slot slot, const Statement* changing)
+{
+	if (slot >= dependents.size())
+		return;
+	for (auto dependent : dependents[slot])
+	{
+		// a statement runs again after its own change only when it read the variable before changing it
+		const auto& statement = statements[dependent];
+		if (&statement == changing && std::find(statement.reads.begin(), statement.reads.end(), slot) == statement.reads.end())
+			continue;
+		pending.insert(dependent);
+	}
+}
+
+}
\ No newline at end of file
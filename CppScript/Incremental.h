@@ -0,0 +1,66 @@
+#pragma once
+
+#include <CppScript/Execution.h>
+#include <set>
+#include <vector>
+
+namespace CppScript
+{
+
+struct IncrementalStatistics
+{
+	std::size_t executed{ 0 };
+	std::size_t skipped{ 0 };
+};
+
+
+// Runs a list of statements, e.g. Assign operations, in order; later runs only execute the statements
+// whose inputs changed since they last ran. A statement runs again when a variable it read or a variable
+// it changed was changed by anything else since, and on every run when it reads a variable it changes
+// itself (e.g. adds into a variable in place). Skipped statements leave their variables as they were,
+// so the context ends as it would after running all statements.
+// Each run only visits the statements depending on changed variables: between runs the runner logs the
+// changes of its context (see Context::setChangeLog), so no other change log may be set on it meanwhile,
+// and changes made in place are only seen once touched. Statements are run as trees, they are
+// referenced and must outlive the runner.
+class IncrementalRunner
+{
+public:
+	explicit IncrementalRunner(Context& cntx);
+	~IncrementalRunner();
+
+	void add(const Operation& statement);
+	// the next run executes all statements
+	void invalidate();
+
+	void run();
+	// script errors are returned instead of thrown, the failing statement runs again on the next run
+	ExecutionError tryRun();
+
+	const IncrementalStatistics& getStatistics() const noexcept;
+
+private:
+	struct Statement
+	{
+		const Operation* operation;
+		std::vector<Context::Slot> reads;
+		std::vector<Context::Slot> changes;
+	};
+
+	ExecutionError execute(std::size_t index);
+	void setDependencies(std::size_t index, bool isDependent);
+	// makes the statements depending on the slot pending, changing is null for changes from outside
+	void changed(Context::Slot slot, const Statement* changing);
+
+	Context& context;
+	Executor executor;
+	std::vector<Statement> statements;
+	// statements reading or changing each slot
+	std::vector<std::vector<std::size_t>> dependents;
+	std::set<std::size_t> pending;
+	std::vector<Context::Slot> changeLog;
+	ExecutionRecord record;
+	IncrementalStatistics statistics;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,399 @@
+#include <CppScript/Jit.h>
+#include <CppScript/Execution.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CPPSCRIPT_JIT_X64
+#endif
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace CppScript
+{
+
+#ifdef _WIN32
+
+ExecutablePages::ExecutablePages(const std::vector<std::uint8_t>& code) : size(code.size())
+{
+	memory = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+	if (!memory)
+		throw std::bad_alloc{};
+	std::memcpy(memory, code.data(), size);
+	DWORD oldProtection;
+	if (!VirtualProtect(memory, size, PAGE_EXECUTE_READ, &oldProtection))
+	{
+		VirtualFree(memory, 0, MEM_RELEASE);
+		throw std::bad_alloc{};
+	}
+	FlushInstructionCache(GetCurrentProcess(), memory, size);
+}
+
+ExecutablePages::~ExecutablePages()
+{
+	VirtualFree(memory, 0, MEM_RELEASE);
+}
+
+#else
+
+ExecutablePages::ExecutablePages(const std::vector<std::uint8_t>& code) : size(code.size())
+{
+	auto* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mapped == MAP_FAILED)
+		throw std::bad_alloc{};
+	std::memcpy(mapped, code.data(), size);
+	if (mprotect(mapped, size, PROT_READ | PROT_EXEC) != 0)
+	{
+		munmap(mapped, size);
+		throw std::bad_alloc{};
+	}
+	memory = mapped;
+}
+
+ExecutablePages::~ExecutablePages()
+{
+	munmap(memory, size);
+}
+
+#endif
+
+const void* ExecutablePages::getEntry() const noexcept
+{
+	return memory;
+}
+
+
+// Encodes the few x86-64 instructions the programs need. Memory operands always use a 32 bit displacement.
+class NativeCode::Assembler
+{
+public:
+	enum Register : std::uint8_t
+	{
+		rax = 0,
+		rcx = 1,
+		rdx = 2,
+		rsi = 6,
+		rdi = 7,
+		r8 = 8,
+		r9 = 9,
+		r10 = 10,
+		r11 = 11
+	};
+
+	// registers holding the variable pointers and the scratch ints during the whole run
+	static constexpr Register variablesBase = r8;
+	static constexpr Register scratchBase = r9;
+
+	Assembler(const std::vector<const Value*>& programConstants, std::int32_t kindOff, std::int32_t intOff)
+		: constants(programConstants), kindOffset(kindOff), intOffset(intOff)
+	{}
+
+	void emitPrologue()
+	{
+#ifdef _WIN32
+		moveRegister(variablesBase, rcx);
+		moveRegister(scratchBase, rdx);
+#else
+		moveRegister(variablesBase, rdi);
+		moveRegister(scratchBase, rsi);
+#endif
+	}
+
+	void emitGuard(std::size_t variable, bool allowNone)
+	{
+		loadVariablePointer(variable, r10);
+		compareByte(r10, kindOffset, std::uint8_t(Value::Kind::Int));
+		if (!allowNone)
+		{
+			failJumps.push_back(jump(0x85));
+			return;
+		}
+		auto isInt = jump(0x84);
+		compareByte(r10, kindOffset, std::uint8_t(Value::Kind::None));
+		failJumps.push_back(jump(0x85));
+		bind(isInt);
+	}
+
+	void emitLoad(const Location& source, Register target)
+	{
+		auto base = address(source, r10);
+		memoryOperation(0x8b, target, base, displacement(source));
+	}
+
+	void emitAdd(const Location& destination, Register source)
+	{
+		auto base = address(destination, r11);
+		memoryOperation(0x01, source, base, displacement(destination));
+	}
+
+	void emitStore(const Location& destination, Register source)
+	{
+		auto base = address(destination, r11);
+		memoryOperation(0x89, source, base, displacement(destination));
+		if (destination.kind == Location::Kind::Variable)
+		{
+			emitRex(false, 0, base);
+			code.push_back(0xc6);
+			emitAddress(0, base, kindOffset);
+			code.push_back(std::uint8_t(Value::Kind::Int));
+		}
+	}
+
+	std::vector<std::uint8_t> finish()
+	{
+		// mov eax, 1; ret
+		code.insert(code.end(), { 0xb8, 1, 0, 0, 0, 0xc3 });
+		for (auto failJump : failJumps)
+			bind(failJump);
+		// xor eax, eax; ret
+		code.insert(code.end(), { 0x31, 0xc0, 0xc3 });
+		return std::move(code);
+	}
+
+private:
+	void emitRex(bool wide, std::uint8_t reg, std::uint8_t base)
+	{
+		std::uint8_t rex = 0x40 | (wide ? 0x08 : 0) | ((reg >> 3) << 2) | (base >> 3);
+		if (rex != 0x40)
+			code.push_back(rex);
+	}
+
+	void emitAddress(std::uint8_t reg, std::uint8_t base, std::int32_t offset)
+	{
+		code.push_back(std::uint8_t(0x80 | ((reg & 7) << 3) | (base & 7)));
+		if ((base & 7) == 4)
+			code.push_back(0x24);
+		emit32(offset);
+	}
+
+	void emit32(std::int32_t value)
+	{
+		std::uint8_t bytes[sizeof(value)];
+		std::memcpy(bytes, &value, sizeof(value));
+		code.insert(code.end(), bytes, bytes + sizeof(bytes));
+	}
+
+	void memoryOperation(std::uint8_t opcode, std::uint8_t reg, std::uint8_t base, std::int32_t offset)
+	{
+		emitRex(true, reg, base);
+		code.push_back(opcode);
+		emitAddress(reg, base, offset);
+	}
+
+	void moveRegister(Register target, Register source)
+	{
+		emitRex(true, source, target);
+		code.push_back(0x89);
+		code.push_back(std::uint8_t(0xc0 | ((source & 7) << 3) | (target & 7)));
+	}
+
+	void compareByte(Register base, std::int32_t offset, std::uint8_t value)
+	{
+		emitRex(false, 0, base);
+		code.push_back(0x80);
+		emitAddress(7, base, offset);
+		code.push_back(value);
+	}
+
+	void loadVariablePointer(std::size_t variable, Register target)
+	{
+		memoryOperation(0x8b, target, variablesBase, std::int32_t(variable * sizeof(Value*)));
+	}
+
+	// conditional jump with a 32 bit displacement to be bound later, returns the displacement position
+	std::size_t jump(std::uint8_t condition)
+	{
+		code.push_back(0x0f);
+		code.push_back(condition);
+		emit32(0);
+		return code.size() - sizeof(std::int32_t);
+	}
+
+	void bind(std::size_t jumpPosition)
+	{
+		auto distance = std::int32_t(code.size() - (jumpPosition + sizeof(std::int32_t)));
+		std::memcpy(code.data() + jumpPosition, &distance, sizeof(distance));
+	}
+
+	// base register of the location's memory, the scratch ints and variable pointers are already in registers
+	Register address(const Location& location, Register temporary)
+	{
+		switch (location.kind)
+		{
+		case Location::Kind::Constant:
+		{
+			emitRex(true, 0, temporary);
+			code.push_back(std::uint8_t(0xb8 | (temporary & 7)));
+			auto pointer = reinterpret_cast<std::uintptr_t>(constants[location.index]);
+			std::uint8_t bytes[sizeof(pointer)];
+			std::memcpy(bytes, &pointer, sizeof(pointer));
+			code.insert(code.end(), bytes, bytes + sizeof(bytes));
+			return temporary;
+		}
+		case Location::Kind::Variable:
+			loadVariablePointer(location.index, temporary);
+			return temporary;
+		default:
+			return scratchBase;
+		}
+	}
+
+	std::int32_t displacement(const Location& location) const
+	{
+		if (location.kind == Location::Kind::Scratch)
+			return std::int32_t(location.index * sizeof(IntValue));
+		return intOffset;
+	}
+
+	const std::vector<const Value*>& constants;
+	std::int32_t kindOffset;
+	std::int32_t intOffset;
+	std::vector<std::uint8_t> code;
+	std::vector<std::size_t> failJumps;
+};
+
+
+bool NativeCode::isSupported() noexcept
+{
+#ifdef CPPSCRIPT_JIT_X64
+	return true;
+#else
+	return false;
+#endif
+}
+
+std::unique_ptr<NativeCode> NativeCode::compile(const Program& program)
+{
+	if (!isSupported() || program.registerCount == 0)
+		return nullptr;
+	for (const auto* constant : program.constants)
+		if (constant->getKind() != Value::Kind::Int)
+			return nullptr;
+
+	// program variables repeat for every use, the native code addresses every slot once
+	std::unique_ptr<NativeCode> native{ new NativeCode };
+	std::vector<std::size_t> variableIndices;
+	for (const auto& variable : program.variables)
+	{
+		if (variable.slot == Context::unresolved)
+			return nullptr;
+		auto slotPos = std::find(native->slots.begin(), native->slots.end(), variable.slot);
+		variableIndices.push_back(std::size_t(slotPos - native->slots.begin()));
+		if (slotPos == native->slots.end())
+			native->slots.push_back(variable.slot);
+	}
+
+	// a variable read before the program assigns it must already hold an int
+	std::vector<bool> isAssigned(native->slots.size(), false);
+	std::vector<bool> needsInt(native->slots.size(), false);
+	for (const auto& instruction : program.code)
+	{
+		if (instruction.code == OpCode::Execute)
+			return nullptr;
+		if (instruction.code == OpCode::Read && !isAssigned[variableIndices[instruction.operand]])
+			needsInt[variableIndices[instruction.operand]] = true;
+		else if (instruction.code == OpCode::Assign)
+			isAssigned[variableIndices[instruction.operand]] = true;
+	}
+
+	Value layout;
+	auto kindOffset = std::int32_t(reinterpret_cast<const char*>(&layout.kind) - reinterpret_cast<const char*>(&layout));
+	auto intOffset = std::int32_t(reinterpret_cast<const char*>(&layout.intValue) - reinterpret_cast<const char*>(&layout));
+	Assembler assembler{ program.constants, kindOffset, intOffset };
+	assembler.emitPrologue();
+	for (std::size_t variable = 0; variable < native->slots.size(); ++variable)
+		assembler.emitGuard(variable, !needsInt[variable]);
+
+	std::vector<Location> registers(program.registerCount, Location{ Location::Kind::Scratch, 0 });
+	std::vector<bool> isChanged(native->slots.size(), false);
+	for (const auto& instruction : program.code)
+	{
+		auto& target = registers[instruction.target];
+		switch (instruction.code)
+		{
+		case OpCode::Value:
+			target = { Location::Kind::Constant, instruction.operand };
+			break;
+		case OpCode::Read:
+			target = { Location::Kind::Variable, variableIndices[instruction.operand] };
+			break;
+		case OpCode::Assign:
+		{
+			Location destination{ Location::Kind::Variable, variableIndices[instruction.operand] };
+			assembler.emitLoad(target, Assembler::rax);
+			assembler.emitStore(destination, Assembler::rax);
+			target = destination;
+			isChanged[destination.index] = true;
+			break;
+		}
+		case OpCode::Clone:
+		{
+			Location destination{ Location::Kind::Scratch, instruction.target };
+			assembler.emitLoad(registers[instruction.operand], Assembler::rax);
+			assembler.emitStore(destination, Assembler::rax);
+			target = destination;
+			break;
+		}
+		case OpCode::Add:
+			if (target.kind == Location::Kind::Constant)
+			{
+				// literals are copied before they are changed
+				Location destination{ Location::Kind::Scratch, instruction.target };
+				assembler.emitLoad(target, Assembler::rax);
+				assembler.emitStore(destination, Assembler::rax);
+				target = destination;
+			}
+			assembler.emitLoad(registers[instruction.operand], Assembler::rax);
+			assembler.emitAdd(target, Assembler::rax);
+			if (target.kind == Location::Kind::Variable)
+				isChanged[target.index] = true;
+			break;
+		default:
+			return nullptr;
+		}
+	}
+
+	native->pages = std::make_unique<ExecutablePages>(assembler.finish());
+	for (std::size_t variable = 0; variable < isChanged.size(); ++variable)
+		if (isChanged[variable])
+			native->changedVariables.push_back(variable);
+	native->constants = program.constants;
+	native->result = registers[0];
+	return native;
+}
+
+Value* NativeCode::run(Context& context, std::vector<Value*>& variables, IntValue* scratch, std::vector<Value>& registerValues) const
+{
+	variables.resize(slots.size());
+	for (std::size_t i = 0; i < slots.size(); ++i)
+	{
+		variables[i] = context.getStorage(slots[i]);
+		if (!variables[i])
+			return nullptr;
+	}
+	auto entry = reinterpret_cast<Entry>(const_cast<void*>(pages->getEntry()));
+	if (!entry(variables.data(), scratch))
+		return nullptr;
+	for (auto variable : changedVariables)
+		context.touch(slots[variable]);
+
+	switch (result.kind)
+	{
+	case Location::Kind::Constant:
+		registerValues[0] = *constants[result.index];
+		return &registerValues[0];
+	case Location::Kind::Variable:
+		return variables[result.index];
+	default:
+		registerValues[result.index] = scratch[result.index];
+		return &registerValues[result.index];
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <CppScript/Value.h>
+#include <CppScript/Context.h>
+#include <memory>
+#include <vector>
+
+namespace CppScript
+{
+
+class Program;
+
+// Executable memory holding generated code, writable while it is filled and executable afterwards.
+class ExecutablePages
+{
+public:
+	explicit ExecutablePages(const std::vector<std::uint8_t>& code);
+	~ExecutablePages();
+
+	ExecutablePages(const ExecutablePages&) = delete;
+	ExecutablePages& operator=(const ExecutablePages&) = delete;
+
+	const void* getEntry() const noexcept;
+
+private:
+	void* memory{ nullptr };
+	std::size_t size{ 0 };
+};
+
+
+// Native x86-64 code of a program whose values are ints. The generated entry checks the kinds of all
+// variables the program touches: variables read before they are assigned have to hold ints, assigned
+// ones ints or nothing. Once the guards pass, every value stays an int, so the body runs without checks.
+// A failed guard makes run return null and leaves the context untouched, the caller then interprets.
+class NativeCode
+{
+public:
+	// null when the program uses other values or operations, or the platform is not x86-64
+	static std::unique_ptr<NativeCode> compile(const Program& program);
+	static bool isSupported() noexcept;
+
+	// scratch needs room for an int per program register, a result in a register lands in registerValues;
+	// variables is resized to hold the addressed values, kept by the caller so runs do not allocate
+	Value* run(Context& context, std::vector<Value*>& variables, IntValue* scratch, std::vector<Value>& registerValues) const;
+
+private:
+	struct Location
+	{
+		enum class Kind : std::uint8_t
+		{
+			Constant,
+			Variable,
+			Scratch
+		};
+
+		Kind kind;
+		std::size_t index;
+	};
+
+	using Entry = int (*)(Value* const* variables, IntValue* scratch);
+
+	class Assembler;
+
+	NativeCode() = default;
+
+	std::unique_ptr<ExecutablePages> pages;
+	std::vector<Context::Slot> slots;
+	// variables the code writes, touched after every run as the interpreter versions them
+	std::vector<std::size_t> changedVariables;
+	std::vector<const Value*> constants;
+	Location result{ Location::Kind::Scratch, 0 };
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,579 @@
+#include <CppScript/JsonStream.h>
+#include <CppScript/NumericArray.h>
+#include <charconv>
+#include <sstream>
+
+namespace CppScript
+{
+
+InvalidJson::InvalidJson(const char* reason, std::size_t position) noexcept
+{
+	std::ostringstream messageStream;
+	messageStream << "Invalid JSON at position " << position << ": " << reason;
+	message = messageStream.str();
+}
+
+const char* InvalidJson::what() const noexcept
+{
+	return message.c_str();
+}
+
+
+static bool isWhitespace(int c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool isValueEnd(int c)
+{
+	return c == std::char_traits<char>::eof() || c == ',' || c == '}' || c == ']' || c == ':' || isWhitespace(c);
+}
+
+
+// -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?, which leaves out forms like 0x1A, inf, +5, .5 or 1.
+static bool isJsonNumber(const std::string& number)
+{
+	auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+	std::size_t i = 0;
+	auto digits = [&]()
+	{
+		auto start = i;
+		while (i < number.size() && isDigit(number[i]))
+			++i;
+		return i > start;
+	};
+	if (i < number.size() && number[i] == '-')
+		++i;
+	if (i < number.size() && number[i] == '0')
+		++i;
+	else if (!digits())
+		return false;
+	if (i < number.size() && number[i] == '.')
+	{
+		++i;
+		if (!digits())
+			return false;
+	}
+	if (i < number.size() && (number[i] == 'e' || number[i] == 'E'))
+	{
+		++i;
+		if (i < number.size() && (number[i] == '+' || number[i] == '-'))
+			++i;
+		if (!digits())
+			return false;
+	}
+	return i == number.size();
+}
+
+
+JsonReader::JsonReader(std::istream& input) : buffer(*input.rdbuf())
+{}
+
+int JsonReader::next()
+{
+	auto c = buffer.sbumpc();
+	if (c == std::char_traits<char>::eof())
+		throw InvalidJson{ "unexpected end of input", position };
+	++position;
+	return c;
+}
+
+void JsonReader::skipWhitespace()
+{
+	while (isWhitespace(buffer.sgetc()))
+	{
+		buffer.sbumpc();
+		++position;
+	}
+}
+
+std::size_t JsonReader::getPosition() const noexcept
+{
+	return position;
+}
+
+char JsonReader::peek()
+{
+	skipWhitespace();
+	auto c = buffer.sgetc();
+	return c == std::char_traits<char>::eof() ? '\0' : char(c);
+}
+
+void JsonReader::expect(char token)
+{
+	if (!consume(token))
+		throw InvalidJson{ "unexpected character", position };
+}
+
+bool JsonReader::consume(char token)
+{
+	if (peek() != token)
+		return false;
+	next();
+	return true;
+}
+
+std::string JsonReader::readString()
+{
+	expect('"');
+	std::string value;
+	for (;;)
+	{
+		auto c = next();
+		if (c == '"')
+			return value;
+		if (c < 0x20)
+			throw InvalidJson{ "control character in string", position };
+		if (c != '\\')
+		{
+			value.push_back(char(c));
+			continue;
+		}
+		switch (next())
+		{
+		case '"':
+			value.push_back('"');
+			break;
+		case '\\':
+			value.push_back('\\');
+			break;
+		case '/':
+			value.push_back('/');
+			break;
+		case 'b':
+			value.push_back('\b');
+			break;
+		case 'f':
+			value.push_back('\f');
+			break;
+		case 'n':
+			value.push_back('\n');
+			break;
+		case 'r':
+			value.push_back('\r');
+			break;
+		case 't':
+			value.push_back('\t');
+			break;
+		case 'u':
+		{
+			auto codePoint = readHex();
+			if (codePoint >= 0xd800 && codePoint < 0xdc00)
+			{
+				if (next() != '\\' || next() != 'u')
+					throw InvalidJson{ "unpaired surrogate", position };
+				auto lowSurrogate = readHex();
+				if (lowSurrogate < 0xdc00 || lowSurrogate >= 0xe000)
+					throw InvalidJson{ "unpaired surrogate", position };
+				codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (lowSurrogate - 0xdc00);
+			}
+			appendCodePoint(value, codePoint);
+			break;
+		}
+		default:
+			throw InvalidJson{ "invalid escape sequence", position };
+		}
+	}
+}
+
+unsigned long JsonReader::readHex()
+{
+	unsigned long value = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		auto c = next();
+		value <<= 4;
+		if (c >= '0' && c <= '9')
+			value |= c - '0';
+		else if (c >= 'a' && c <= 'f')
+			value |= c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')
+			value |= c - 'A' + 10;
+		else
+			throw InvalidJson{ "invalid unicode escape", position };
+	}
+	return value;
+}
+
+void JsonReader::appendCodePoint(std::string& output, unsigned long codePoint)
+{
+	if (codePoint < 0x80)
+		output.push_back(char(codePoint));
+	else if (codePoint < 0x800)
+	{
+		output.push_back(char(0xc0 | (codePoint >> 6)));
+		output.push_back(char(0x80 | (codePoint & 0x3f)));
+	}
+	else if (codePoint < 0x10000)
+	{
+		output.push_back(char(0xe0 | (codePoint >> 12)));
+		output.push_back(char(0x80 | ((codePoint >> 6) & 0x3f)));
+		output.push_back(char(0x80 | (codePoint & 0x3f)));
+	}
+	else
+	{
+		output.push_back(char(0xf0 | (codePoint >> 18)));
+		output.push_back(char(0x80 | ((codePoint >> 12) & 0x3f)));
+		output.push_back(char(0x80 | ((codePoint >> 6) & 0x3f)));
+		output.push_back(char(0x80 | (codePoint & 0x3f)));
+	}
+}
+
+void JsonReader::readKeyword(const char* keyword)
+{
+	for (; *keyword; ++keyword)
+		if (next() != *keyword)
+			throw InvalidJson{ "invalid literal", position };
+	if (!isValueEnd(buffer.sgetc()))
+		throw InvalidJson{ "invalid literal", position };
+}
+
+void JsonReader::readNumber(std::string& number)
+{
+	while (!isValueEnd(buffer.sgetc()))
+		number.push_back(char(next()));
+}
+
+Value JsonReader::readLiteral()
+{
+	switch (peek())
+	{
+	case 't':
+		readKeyword("true");
+		return true;
+	case 'f':
+		readKeyword("false");
+		return false;
+	case 'n':
+		readKeyword("null");
+		throw NotBaseType{ "null" };
+	case '"':
+		throw NotBaseType{ "string" };
+	case '[':
+		throw NotBaseType{ "array" };
+	case '{':
+		throw NotBaseType{ "object" };
+	default:
+		break;
+	}
+
+	std::string number;
+	readNumber(number);
+	if (number.empty())
+		throw InvalidJson{ "value expected", position };
+	if (!isJsonNumber(number))
+		throw InvalidJson{ "invalid number", position };
+	// from_chars ignores the locale, which could expect another decimal separator
+	const auto* numberEnd = number.data() + number.size();
+	if (number.find_first_of(".eE") == std::string::npos)
+	{
+		IntValue intValue;
+		if (std::from_chars(number.data(), numberEnd, intValue).ec == std::errc{})
+			return intValue;
+	}
+	FloatValue floatValue;
+	auto result = std::from_chars(number.data(), numberEnd, floatValue);
+	if (result.ec != std::errc{} || result.ptr != numberEnd)
+		throw InvalidJson{ "invalid number", position };
+	return floatValue;
+}
+
+void JsonReader::skipValue()
+{
+	skipWhitespace();
+	int depth = 0;
+	bool inString = false;
+	for (;;)
+	{
+		auto c = next();
+		if (inString)
+		{
+			if (c == '\\')
+				next();
+			else if (c == '"')
+			{
+				inString = false;
+				if (depth == 0)
+					return;
+			}
+			continue;
+		}
+		switch (c)
+		{
+		case '"':
+			inString = true;
+			break;
+		case '{':
+		case '[':
+			++depth;
+			break;
+		case '}':
+		case ']':
+			if (--depth < 0)
+				throw InvalidJson{ "unexpected character", position };
+			if (depth == 0)
+				return;
+			break;
+		default:
+			if (depth == 0 && isValueEnd(buffer.sgetc()))
+				return;
+		}
+	}
+}
+
+
+// Hands the fields read ahead of the operation type to the operation, in order.
+class JsonStreamLoader::PendingDataLoader : public Serializer
+{
+public:
+	PendingDataLoader(std::vector<DataField>& fields, std::size_t position) noexcept : fields(fields), position(position)
+	{}
+
+	virtual void serialize(Operation::Ref& obj) override
+	{
+		auto* operation = std::get_if<Operation::Ref>(&next());
+		if (!operation)
+			throw InvalidJson{ "operation expected", position };
+		obj = std::move(*operation);
+	}
+
+	virtual void serialize(Value& value) override
+	{
+		auto& field = next();
+		auto* literal = std::get_if<Value>(&field);
+		if (!literal)
+			throw NotBaseType{ std::holds_alternative<std::string>(field) ? "string" : "object" };
+		value = std::move(*literal);
+	}
+
+	virtual void serialize(std::string& value) override
+	{
+		value = nextString();
+	}
+
+	virtual void serialize(Variable& value) override
+	{
+		value.name = nextString();
+	}
+
+private:
+	DataField& next()
+	{
+		if (index == fields.size())
+			throw InvalidJson{ "operation expects more data", position };
+		return fields[index++];
+	}
+
+	std::string nextString()
+	{
+		auto* text = std::get_if<std::string>(&next());
+		if (!text)
+			throw InvalidJson{ "string expected", position };
+		return std::move(*text);
+	}
+
+	std::vector<DataField>& fields;
+	std::size_t index{ 0 };
+	std::size_t position;
+};
+
+
+JsonStreamLoader::JsonStreamLoader(std::istream& input) : reader(input)
+{}
+
+void JsonStreamLoader::setSourceMap(SourceMap& map)
+{
+	sourceMap = &map;
+}
+
+void JsonStreamLoader::serialize(Operation::Ref& obj)
+{
+	beginField();
+	std::string opPath;
+	if (sourceMap && !frames.empty())
+		opPath = frames.back().isArray ? frames.back().path + '/' + std::to_string(frames.back().fieldCount - 1) : frames.back().path;
+	loadOperation(obj, opPath);
+}
+
+void JsonStreamLoader::loadOperation(Operation::Ref& obj, const std::string& opPath)
+{
+	obj.reset();
+	reader.peek();
+	auto opOffset = reader.getPosition();
+	reader.expect('{');
+	PendingData pendingData;
+	bool hasPendingData = false;
+	bool hasData = false;
+	if (reader.peek() != '}')
+		do
+		{
+			auto key = reader.readString();
+			reader.expect(':');
+			if (key == "type" && !obj)
+			{
+				auto typePosition = reader.getPosition();
+				obj = Operation::create(reader.readString());
+				if (!obj)
+					throw InvalidJson{ "unknown operation type", typePosition };
+				if (sourceMap)
+					(*sourceMap)[obj.get()] = { opPath, opOffset };
+				if (hasPendingData)
+				{
+					loadPendingData(*obj, pendingData);
+					hasData = true;
+				}
+			}
+			else if (key == "data" && obj && !hasData)
+			{
+				serializeData(*obj, opPath + "/data");
+				hasData = true;
+			}
+			else if (key == "data" && !obj && !hasPendingData)
+			{
+				readPendingData(pendingData, opPath + "/data");
+				hasPendingData = true;
+			}
+			else
+				reader.skipValue();
+		} while (reader.consume(','));
+	reader.expect('}');
+	if (!obj)
+		throw InvalidJson{ "operation type is missing", opOffset };
+	if (!hasData)
+		throw InvalidJson{ "operation data is missing", opOffset };
+}
+
+void JsonStreamLoader::serialize(Value& value)
+{
+	beginField();
+	value = reader.peek() == '[' ? readArray() : reader.readLiteral();
+}
+
+void JsonStreamLoader::serialize(std::string& value)
+{
+	beginField();
+	value = reader.readString();
+}
+
+void JsonStreamLoader::serialize(Variable& value)
+{
+	beginField();
+	value.name = reader.readString();
+}
+
+Value JsonStreamLoader::readArray()
+{
+	reader.expect('[');
+	std::vector<Value> elements;
+	if (reader.peek() != ']')
+		do
+		{
+			if (reader.peek() == '[')
+				throw NotBaseType{ "array" };
+			elements.push_back(reader.readLiteral());
+		} while (reader.consume(','));
+	reader.expect(']');
+	return makeArray(elements);
+}
+
+Value JsonStreamLoader::makeArray(const std::vector<Value>& elements)
+{
+	auto isFloat = false;
+	for (const auto& element : elements)
+		if (element.getKind() == Value::Kind::Float)
+			isFloat = true;
+		else if (element.getKind() != Value::Kind::Int)
+			throw NotBaseType{ element.getKind() == Value::Kind::Bool ? "boolean" : "array" };
+
+	auto array = TypeArray::create(isFloat ? NumericArray::ElementKind::Float : NumericArray::ElementKind::Int, elements.size());
+	for (std::size_t i = 0; i < elements.size(); ++i)
+		if (isFloat)
+			array->get().getFloats()[i] = elements[i].getKind() == Value::Kind::Int ? FloatValue(elements[i].as<IntValue>()) : elements[i].as<FloatValue>();
+		else
+			array->get().getInts()[i] = elements[i].as<IntValue>();
+	return array;
+}
+
+void JsonStreamLoader::beginField()
+{
+	if (frames.empty())
+		return;
+	auto& frame = frames.back();
+	if (frame.fieldCount > 0)
+	{
+		if (!frame.isArray)
+			throw InvalidJson{ "operation expects more data", reader.getPosition() };
+		reader.expect(',');
+	}
+	++frame.fieldCount;
+}
+
+void JsonStreamLoader::serializeData(Operation& obj, std::string dataPath)
+{
+	// an array given to a Value operation is its literal, not its field list
+	bool isArray = obj.getType() != OperationType::Value && reader.consume('[');
+	frames.push_back({ isArray, 0, std::move(dataPath) });
+	obj.serialize(*this);
+	frames.pop_back();
+	if (isArray)
+	{
+		while (reader.consume(','))
+			reader.skipValue();
+		reader.expect(']');
+	}
+}
+
+void JsonStreamLoader::readPendingData(PendingData& data, const std::string& dataPath)
+{
+	// the fields are built as they are read, nested operations stream like any other, so no text is kept
+	// for the type that comes later; an array is kept as a field list until the type tells it is a literal
+	data.isArray = reader.consume('[');
+	if (!data.isArray || reader.peek() != ']')
+		do
+		{
+			switch (reader.peek())
+			{
+			case '{':
+			{
+				std::string fieldPath;
+				if (sourceMap)
+					fieldPath = data.isArray ? dataPath + '/' + std::to_string(data.fields.size()) : dataPath;
+				Operation::Ref operation;
+				loadOperation(operation, fieldPath);
+				data.fields.emplace_back(std::in_place_type<Operation::Ref>, std::move(operation));
+				break;
+			}
+			case '"':
+				data.fields.emplace_back(std::in_place_type<std::string>, reader.readString());
+				break;
+			case '[':
+				data.fields.emplace_back(std::in_place_type<Value>, readArray());
+				break;
+			default:
+				data.fields.emplace_back(std::in_place_type<Value>, reader.readLiteral());
+			}
+		} while (data.isArray && reader.consume(','));
+	if (data.isArray)
+		reader.expect(']');
+}
+
+void JsonStreamLoader::loadPendingData(Operation& obj, PendingData& data)
+{
+	if (obj.getType() == OperationType::Value && data.isArray)
+	{
+		std::vector<Value> elements;
+		for (auto& field : data.fields)
+		{
+			auto* element = std::get_if<Value>(&field);
+			if (!element)
+				throw NotBaseType{ std::holds_alternative<std::string>(field) ? "string" : "object" };
+			elements.push_back(std::move(*element));
+		}
+		data.fields.clear();
+		data.fields.emplace_back(std::in_place_type<Value>, makeArray(elements));
+	}
+	PendingDataLoader loader{ data.fields, reader.getPosition() };
+	obj.serialize(loader);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <CppScript/Serializer.h>
+#include <istream>
+#include <variant>
+#include <vector>
+
+
+namespace CppScript
+{
+
+	class InvalidJson : public std::exception
+	{
+	public:
+		InvalidJson(const char* reason, std::size_t position) noexcept;
+
+		virtual const char* what() const noexcept override;
+
+	private:
+		std::string message;
+	};
+
+
+	// Pull tokenizer over a character stream, it never holds more than the current token.
+	class JsonReader
+	{
+	public:
+		explicit JsonReader(std::istream& input);
+
+		char peek();
+		void expect(char token);
+		bool consume(char token);
+
+		std::size_t getPosition() const noexcept;
+
+		std::string readString();
+		Value readLiteral();
+		void skipValue();
+
+	private:
+		int next();
+		void skipWhitespace();
+		void readKeyword(const char* keyword);
+		void readNumber(std::string& number);
+		void appendCodePoint(std::string& output, unsigned long codePoint);
+		unsigned long readHex();
+
+		std::streambuf& buffer;
+		std::size_t position{ 0 };
+	};
+
+
+	// Builds operations directly from a JSON character stream, accepting the same layout as JsonLoader.
+	class JsonStreamLoader : public Serializer
+	{
+	public:
+		explicit JsonStreamLoader(std::istream& input);
+
+		// records the position of every operation loaded afterwards
+		void setSourceMap(SourceMap& map);
+
+		virtual void serialize(Operation::Ref& obj) override;
+
+		virtual void serialize(Value& value) override;
+		virtual void serialize(std::string& value) override;
+		virtual void serialize(Variable& value) override;
+
+	private:
+		struct DataFrame
+		{
+			bool isArray;
+			std::size_t fieldCount;
+			std::string path;
+		};
+
+		// data read before the type of its operation is known, operations and literals already built
+		using DataField = std::variant<Operation::Ref, Value, std::string>;
+		struct PendingData
+		{
+			bool isArray;
+			std::vector<DataField> fields;
+		};
+		class PendingDataLoader;
+
+		void beginField();
+		void loadOperation(Operation::Ref& obj, const std::string& opPath);
+		void serializeData(Operation& obj, std::string dataPath);
+		void readPendingData(PendingData& data, const std::string& dataPath);
+		void loadPendingData(Operation& obj, PendingData& data);
+		Value readArray();
+		static Value makeArray(const std::vector<Value>& elements);
+
+		JsonReader reader;
+		std::vector<DataFrame> frames;
+		SourceMap* sourceMap{ nullptr };
+	};
+
+}
\ No newline at end of file
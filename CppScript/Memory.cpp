@@ -0,0 +1,106 @@
+#include <CppScript/Memory.h>
+#include <array>
+
+namespace CppScript
+{
+
+namespace
+{
+
+struct FreeBlock
+{
+	FreeBlock* next;
+};
+
+thread_local bool poolsReleased = false;
+
+class ThreadPools
+{
+public:
+	static constexpr std::size_t classCount = TypePool::maxPooledSize / TypePool::granularity;
+
+	~ThreadPools()
+	{
+		poolsReleased = true;
+		for (auto block : freeLists)
+			while (block)
+			{
+				auto next = block->next;
+				::operator delete(block);
+				block = next;
+			}
+	}
+
+	std::array<FreeBlock*, classCount> freeLists{};
+	std::array<std::size_t, classCount> freeCounts{};
+	AllocationStatistics statistics;
+};
+
+thread_local ThreadPools pools;
+
+std::size_t getSizeClass(std::size_t size) noexcept
+{
+	return (size + TypePool::granularity - 1) / TypePool::granularity - 1;
+}
+
+}
+
+
+void* TypePool::allocate(std::size_t size)
+{
+	if (poolsReleased)
+		return ::operator new(size);
+	++pools.statistics.allocations;
+	if (size == 0 || size > maxPooledSize)
+	{
+		++pools.statistics.systemAllocations;
+		return ::operator new(size);
+	}
+	auto sizeClass = getSizeClass(size);
+	if (auto block = pools.freeLists[sizeClass])
+	{
+		pools.freeLists[sizeClass] = block->next;
+		--pools.freeCounts[sizeClass];
+		++pools.statistics.poolHits;
+		return block;
+	}
+	++pools.statistics.systemAllocations;
+	return ::operator new((sizeClass + 1) * granularity);
+}
+
+void TypePool::deallocate(void* block, std::size_t size) noexcept
+{
+	if (poolsReleased)
+	{
+		::operator delete(block);
+		return;
+	}
+	++pools.statistics.deallocations;
+	if (size == 0 || size > maxPooledSize)
+	{
+		::operator delete(block);
+		return;
+	}
+	auto sizeClass = getSizeClass(size);
+	if (pools.freeCounts[sizeClass] >= maxFreeBlocks)
+	{
+		::operator delete(block);
+		return;
+	}
+	auto freeBlock = static_cast<FreeBlock*>(block);
+	freeBlock->next = pools.freeLists[sizeClass];
+	pools.freeLists[sizeClass] = freeBlock;
+	++pools.freeCounts[sizeClass];
+}
+
+const AllocationStatistics& TypePool::getStatistics() noexcept
+{
+	return pools.statistics;
+}
+
+void TypePool::resetStatistics() noexcept
+{
+	pools.statistics = {};
+}
+
+}
\ No newline at end of file
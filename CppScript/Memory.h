@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <atomic>
+#include <utility>
+#include <type_traits>
+
+
+namespace CppScript
+{
+
+	struct AllocationStatistics
+	{
+		std::size_t allocations{ 0 };
+		std::size_t deallocations{ 0 };
+		std::size_t poolHits{ 0 };
+		std::size_t systemAllocations{ 0 };
+	};
+
+
+	// Size-class pools for small objects. Every thread keeps its own free lists and statistics,
+	// blocks may be released on any thread.
+	class TypePool
+	{
+	public:
+		static void* allocate(std::size_t size);
+		static void deallocate(void* block, std::size_t size) noexcept;
+
+		static const AllocationStatistics& getStatistics() noexcept;
+		static void resetStatistics() noexcept;
+
+		static constexpr std::size_t granularity = 16;
+		static constexpr std::size_t maxPooledSize = 256;
+		static constexpr std::size_t maxFreeBlocks = 4096;
+	};
+
+
+	// Intrusive reference count. Counts are atomic unless CPPSCRIPT_NONATOMIC_REFCOUNT is defined,
+	// which is only safe when objects never cross threads.
+	class RefCounted
+	{
+	public:
+		RefCounted() noexcept = default;
+		RefCounted(const RefCounted&) noexcept
+		{}
+
+		RefCounted& operator=(const RefCounted&) noexcept
+		{
+			return *this;
+		}
+
+		void addReference() const noexcept
+		{
+#ifdef CPPSCRIPT_NONATOMIC_REFCOUNT
+			++referenceCount;
+#else
+			referenceCount.fetch_add(1, std::memory_order_relaxed);
+#endif
+		}
+
+		bool releaseReference() const noexcept
+		{
+#ifdef CPPSCRIPT_NONATOMIC_REFCOUNT
+			return --referenceCount == 0;
+#else
+			return referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1;
+#endif
+		}
+
+		std::uint32_t getReferenceCount() const noexcept
+		{
+#ifdef CPPSCRIPT_NONATOMIC_REFCOUNT
+			return referenceCount;
+#else
+			return referenceCount.load(std::memory_order_relaxed);
+#endif
+		}
+
+		// other references see changes made through this one, so copy-on-write values copy it first
+		bool isShared() const noexcept
+		{
+			return getReferenceCount() > 1;
+		}
+
+	protected:
+		~RefCounted() = default;
+
+	private:
+#ifdef CPPSCRIPT_NONATOMIC_REFCOUNT
+		mutable std::uint32_t referenceCount{ 0 };
+#else
+		mutable std::atomic<std::uint32_t> referenceCount{ 0 };
+#endif
+	};
+
+
+	template <typename T> class RefPtr
+	{
+	public:
+		using element_type = T;
+
+		RefPtr() noexcept = default;
+		RefPtr(std::nullptr_t) noexcept
+		{}
+		explicit RefPtr(T* obj) noexcept : pointer(obj)
+		{
+			if (pointer)
+				pointer->addReference();
+		}
+
+		RefPtr(const RefPtr& other) noexcept : RefPtr(other.pointer)
+		{}
+		template <typename U, std::enable_if_t<std::is_convertible_v<U*, T*>, int> = 0> RefPtr(const RefPtr<U>& other) noexcept
+			: RefPtr(other.get())
+		{}
+
+		RefPtr(RefPtr&& other) noexcept : pointer(std::exchange(other.pointer, nullptr))
+		{}
+		template <typename U, std::enable_if_t<std::is_convertible_v<U*, T*>, int> = 0> RefPtr(RefPtr<U>&& other) noexcept
+			: pointer(other.release())
+		{}
+
+		~RefPtr()
+		{
+			reset();
+		}
+
+		RefPtr& operator=(RefPtr other) noexcept
+		{
+			std::swap(pointer, other.pointer);
+			return *this;
+		}
+
+		void reset() noexcept
+		{
+			if (pointer && pointer->releaseReference())
+				delete pointer;
+			pointer = nullptr;
+		}
+
+		T* release() noexcept
+		{
+			return std::exchange(pointer, nullptr);
+		}
+
+		T* get() const noexcept
+		{
+			return pointer;
+		}
+
+		T& operator*() const noexcept
+		{
+			return *pointer;
+		}
+
+		T* operator->() const noexcept
+		{
+			return pointer;
+		}
+
+		explicit operator bool() const noexcept
+		{
+			return pointer != nullptr;
+		}
+
+		template <typename U> bool operator==(const RefPtr<U>& other) const noexcept
+		{
+			return pointer == other.get();
+		}
+
+		template <typename U> bool operator!=(const RefPtr<U>& other) const noexcept
+		{
+			return pointer != other.get();
+		}
+
+	private:
+		T* pointer{ nullptr };
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include <CppScript/NumericArray.h>
+#include <CppScript/ArrayKernels.h>
+#include <algorithm>
+#include <cstring>
+
+namespace CppScript
+{
+
+template<> TypeId<NumericArray> Type<NumericArray>::typeId{ "array" };
+template class Type<NumericArray>;
+
+
+NumericArray::NumericArray(ElementKind kind, std::size_t size) : elementKind(kind)
+{
+	allocate(size);
+	if (size > 0)
+		std::memset(data, 0, size * elementSize);
+}
+
+NumericArray::NumericArray(std::initializer_list<IntValue> values) : NumericArray(ElementKind::Int, values.size())
+{
+	std::copy(values.begin(), values.end(), getInts());
+}
+
+NumericArray::NumericArray(std::initializer_list<FloatValue> values) : NumericArray(ElementKind::Float, values.size())
+{
+	std::copy(values.begin(), values.end(), getFloats());
+}
+
+NumericArray::NumericArray(const NumericArray& other) : elementKind(other.elementKind)
+{
+	allocate(other.elementCount);
+	if (elementCount > 0)
+		std::memcpy(data, other.data, elementCount * elementSize);
+}
+
+NumericArray::NumericArray(NumericArray&& other) noexcept
+	: elementKind(other.elementKind), elementCount(std::exchange(other.elementCount, 0)), data(std::exchange(other.data, nullptr))
+{}
+
+NumericArray::~NumericArray()
+{
+	release();
+}
+
+NumericArray& NumericArray::operator=(NumericArray other) noexcept
+{
+	std::swap(elementKind, other.elementKind);
+	std::swap(elementCount, other.elementCount);
+	std::swap(data, other.data);
+	return *this;
+}
+
+NumericArray::ElementKind NumericArray::getElementKind() const noexcept
+{
+	return elementKind;
+}
+
+std::size_t NumericArray::size() const noexcept
+{
+	return elementCount;
+}
+
+IntValue* NumericArray::getInts()
+{
+	return const_cast<IntValue*>(static_cast<const NumericArray&>(*this).getInts());
+}
+
+const IntValue* NumericArray::getInts() const
+{
+	if (elementKind != ElementKind::Int)
+		throw InvalidTypeCast{ "float array", "int array" };
+	return static_cast<const IntValue*>(data);
+}
+
+FloatValue* NumericArray::getFloats()
+{
+	return const_cast<FloatValue*>(static_cast<const NumericArray&>(*this).getFloats());
+}
+
+const FloatValue* NumericArray::getFloats() const
+{
+	if (elementKind != ElementKind::Float)
+		throw InvalidTypeCast{ "int array", "float array" };
+	return static_cast<const FloatValue*>(data);
+}
+
+FloatValue NumericArray::getAsFloat(std::size_t index) const
+{
+	return elementKind == ElementKind::Int ? FloatValue(getInts()[index]) : getFloats()[index];
+}
+
+void NumericArray::convertToFloat()
+{
+	if (elementKind == ElementKind::Float)
+		return;
+	NumericArray converted{ ElementKind::Float, elementCount };
+	std::transform(getInts(), getInts() + elementCount, converted.getFloats(), [](IntValue value) { return FloatValue(value); });
+	*this = std::move(converted);
+}
+
+ExecutionError NumericArray::getAdditionError(const NumericArray& other) const noexcept
+{
+	if (elementCount != other.elementCount)
+		return { ErrorCode::InvalidOperation, "array", "Addition of arrays of different size" };
+	if (elementKind == ElementKind::Int && other.elementKind == ElementKind::Float)
+		return { ErrorCode::InvalidTypeCast, "float array", "int array" };
+	return {};
+}
+
+ExecutionError NumericArray::getAdditionError(ElementKind scalarKind) const noexcept
+{
+	if (elementKind == ElementKind::Int && scalarKind == ElementKind::Float)
+		return { ErrorCode::InvalidTypeCast, "int array", "float array" };
+	return {};
+}
+
+NumericArray& NumericArray::operator+=(const NumericArray& other)
+{
+	if (auto error = getAdditionError(other))
+		error.raise();
+	const auto& kernels = ArrayKernels::get();
+	if (elementKind == ElementKind::Int)
+		kernels.addInts(getInts(), other.getInts(), elementCount);
+	else if (other.elementKind == ElementKind::Float)
+		kernels.addFloats(getFloats(), other.getFloats(), elementCount);
+	else
+	{
+		auto* floats = getFloats();
+		const auto* ints = other.getInts();
+		for (std::size_t i = 0; i < elementCount; ++i)
+			floats[i] += FloatValue(ints[i]);
+	}
+	return *this;
+}
+
+NumericArray& NumericArray::operator+=(IntValue other)
+{
+	if (elementKind == ElementKind::Int)
+		ArrayKernels::get().addIntScalar(getInts(), other, elementCount);
+	else
+		ArrayKernels::get().addFloatScalar(getFloats(), FloatValue(other), elementCount);
+	return *this;
+}
+
+NumericArray& NumericArray::operator+=(FloatValue other)
+{
+	ArrayKernels::get().addFloatScalar(getFloats(), other, elementCount);
+	return *this;
+}
+
+bool NumericArray::operator==(const NumericArray& other) const
+{
+	if (elementCount != other.elementCount)
+		return false;
+	if (elementKind == ElementKind::Int && other.elementKind == ElementKind::Int)
+		return elementCount == 0 || std::memcmp(data, other.data, elementCount * sizeof(IntValue)) == 0;
+	if (elementKind == ElementKind::Float && other.elementKind == ElementKind::Float)
+		return ArrayKernels::get().equalFloats(getFloats(), other.getFloats(), elementCount);
+	for (std::size_t i = 0; i < elementCount; ++i)
+		if (!(getAsFloat(i) == other.getAsFloat(i)))
+			return false;
+	return true;
+}
+
+bool NumericArray::operator<(const NumericArray& other) const
+{
+	auto commonCount = std::min(elementCount, other.elementCount);
+	if (elementKind == ElementKind::Int && other.elementKind == ElementKind::Int)
+		return std::lexicographical_compare(getInts(), getInts() + elementCount, other.getInts(), other.getInts() + other.elementCount);
+	for (std::size_t i = 0; i < commonCount; ++i)
+	{
+		auto left = getAsFloat(i), right = other.getAsFloat(i);
+		if (left < right)
+			return true;
+		if (right < left)
+			return false;
+	}
+	return elementCount < other.elementCount;
+}
+
+Value NumericArray::sum() const
+{
+	if (elementKind == ElementKind::Int)
+		return ArrayKernels::get().sumInts(getInts(), elementCount);
+	return ArrayKernels::get().sumFloats(getFloats(), elementCount);
+}
+
+Value NumericArray::min() const
+{
+	if (elementCount == 0)
+		return {};
+	if (elementKind == ElementKind::Int)
+		return *std::min_element(getInts(), getInts() + elementCount);
+	return *std::min_element(getFloats(), getFloats() + elementCount);
+}
+
+Value NumericArray::max() const
+{
+	if (elementCount == 0)
+		return {};
+	if (elementKind == ElementKind::Int)
+		return *std::max_element(getInts(), getInts() + elementCount);
+	return *std::max_element(getFloats(), getFloats() + elementCount);
+}
+
+void NumericArray::allocate(std::size_t size)
+{
+	if (size > 0)
+		data = ::operator new(size * elementSize, std::align_val_t{ alignment });
+	elementCount = size;
+}
+
+void NumericArray::release() noexcept
+{
+	if (data)
+		::operator delete(data, std::align_val_t{ alignment });
+	data = nullptr;
+	elementCount = 0;
+}
+
+
+bool TypeOperations<NumericArray>::isClonable() const noexcept
+{
+	return true;
+}
+
+TypeBase::Ref TypeOperations<NumericArray>::clone() const
+{
+	return TypeArray::create(getThis().get());
+}
+
+TypeBase::Ref TypeOperations<NumericArray>::operator+=(const TypeBase& obj)
+{
+	if (isShared())
+		return *clone() += obj;
+	auto& array = getThis().get();
+	if (obj.getId() == TypeInt::id())
+		array += obj.as<IntValue>();
+	else if (obj.getId() == TypeFloat::id())
+		array += obj.as<FloatValue>();
+	else
+		array += obj.as<NumericArray>();
+	return getRef();
+}
+
+bool TypeOperations<NumericArray>::operator==(const TypeBase& obj) const
+{
+	return getThis().get() == obj.as<NumericArray>();
+}
+
+bool TypeOperations<NumericArray>::operator<(const TypeBase& obj) const
+{
+	return getThis().get() < obj.as<NumericArray>();
+}
+
+const Type<NumericArray>& TypeOperations<NumericArray>::getThis() const
+{
+	return static_cast<const Type<NumericArray>&>(*this);
+}
+
+Type<NumericArray>& TypeOperations<NumericArray>::getThis()
+{
+	return static_cast<Type<NumericArray>&>(*this);
+}
+
+}
\ No newline at end of file
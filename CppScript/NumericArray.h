@@ -0,0 +1,98 @@
+#pragma once
+
+#include <CppScript/Value.h>
+#include <algorithm>
+#include <initializer_list>
+#include <type_traits>
+
+
+namespace CppScript
+{
+
+	// Contiguous array of ints or floats, the storage is aligned for the widest SIMD kernels.
+	// Int arrays follow the scalar promotion rules: adding floats to them is an invalid cast.
+	class NumericArray
+	{
+	public:
+		enum class ElementKind : std::uint8_t
+		{
+			Int,
+			Float
+		};
+
+		static constexpr std::size_t alignment = 32;
+
+		NumericArray() noexcept = default;
+		NumericArray(ElementKind kind, std::size_t size);
+		NumericArray(std::initializer_list<IntValue> values);
+		NumericArray(std::initializer_list<FloatValue> values);
+		// double literals under the float profiles other than double
+		template <typename T, std::enable_if_t<std::is_same_v<T, double> && !std::is_same_v<T, FloatValue>, int> = 0>
+			NumericArray(std::initializer_list<T> values) : NumericArray(ElementKind::Float, values.size())
+		{
+			std::transform(values.begin(), values.end(), getFloats(), [](T value) { return FloatValue(value); });
+		}
+		NumericArray(const NumericArray& other);
+		NumericArray(NumericArray&& other) noexcept;
+		~NumericArray();
+
+		NumericArray& operator=(NumericArray other) noexcept;
+
+		ElementKind getElementKind() const noexcept;
+		std::size_t size() const noexcept;
+
+		IntValue* getInts();
+		const IntValue* getInts() const;
+		FloatValue* getFloats();
+		const FloatValue* getFloats() const;
+		FloatValue getAsFloat(std::size_t index) const;
+
+		void convertToFloat();
+
+		// the error the addition would throw, without adding
+		ExecutionError getAdditionError(const NumericArray& other) const noexcept;
+		ExecutionError getAdditionError(ElementKind scalarKind) const noexcept;
+
+		NumericArray& operator+=(const NumericArray& other);
+		NumericArray& operator+=(IntValue other);
+		NumericArray& operator+=(FloatValue other);
+
+		bool operator==(const NumericArray& other) const;
+		bool operator<(const NumericArray& other) const;
+
+		Value sum() const;
+		Value min() const;
+		Value max() const;
+
+	private:
+		static constexpr std::size_t elementSize = sizeof(IntValue) > sizeof(FloatValue) ? sizeof(IntValue) : sizeof(FloatValue);
+
+		void allocate(std::size_t size);
+		void release() noexcept;
+
+		ElementKind elementKind{ ElementKind::Int };
+		std::size_t elementCount{ 0 };
+		void* data{ nullptr };
+	};
+
+
+	template <> class TypeOperations<NumericArray> : public TypeBase
+	{
+	public:
+		virtual bool isClonable() const noexcept override;
+		virtual TypeBase::Ref clone() const override;
+		virtual TypeBase::Ref operator+=(const TypeBase& obj) override;
+		virtual bool operator==(const TypeBase& obj) const override;
+		virtual bool operator<(const TypeBase& obj) const override;
+
+	private:
+		const Type<NumericArray>& getThis() const;
+		Type<NumericArray>& getThis();
+	};
+
+
+	extern template class Type<NumericArray>;
+
+	using TypeArray = Type<NumericArray>;
+
+}
\ No newline at end of file
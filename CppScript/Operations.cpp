@@ -2,7 +2,9 @@
 #include <CppScript/TypeWrapper.h>
 #include <CppScript/Serializer.h>
 #include <CppScript/Execution.h>
+#include <CppScript/NumericArray.h>
 #include <array>
+#include <cmath>
 
 namespace CppScript
 {
@@ -16,7 +18,7 @@ public:
 	using Creators = std::array<OperationCreator*, size_t(OperationType::Last)>;
 	static Creators creators;
 	
-	using Names = std::unordered_map<std::string, OperationType>;
+	using Names = std::unordered_map<Symbol, OperationType>;
 	static Names names;
 };
 
@@ -27,7 +29,7 @@ OperationCreator::Names OperationCreator::names;
 template <class O> class OpCreator : public OperationCreator
 {
 public:
-	constexpr OpCreator(const char* opName) : name(opName)
+	OpCreator(const char* opName) : name(opName)
 	{
 		creators[size_t(O::getOpType())] = this;
 		names[name] = O::getOpType();
@@ -40,11 +42,11 @@ public:
 
 	virtual const std::string& getName() const override
 	{
-		return name;
+		return name.str();
 	}
 
 private:
-	std::string name;
+	Symbol name;
 };
 
 OpCreator<ValueOperation> valueOp{ "Value" };
@@ -52,6 +54,8 @@ OpCreator<ReadOperation> readOp{ "Read" };
 OpCreator<AssignOperation> assignOp{ "Assign" };
 OpCreator<CloneOperation> cloneOp{ "Clone" };
 OpCreator<AddOperation> addOp{ "Add" };
+OpCreator<RangeOperation> rangeOp{ "Range" };
+OpCreator<ForLoopOperation> forLoopOp{ "ForLoop" };
 
 
 Operation::Ref Operation::create(OperationType opType)
@@ -61,18 +65,23 @@ Operation::Ref Operation::create(OperationType opType)
 
 Operation::Ref Operation::create(const std::string& opType)
 {
-	return create(OperationCreator::names[opType]);
+	// names are only looked up, so unknown ones do not grow the symbol table
+	auto name = Symbol::find(opType);
+	if (!name)
+		return nullptr;
+	auto namePos = OperationCreator::names.find(*name);
+	return namePos != OperationCreator::names.end() ? create(namePos->second) : nullptr;
 }
 
-const std::string& getName(OperationType opType)
+const std::string& Operation::getName(OperationType opType)
 {
 	return OperationCreator::creators[size_t(opType)]->getName();
 }
 
 
-TypeBase::Ref ValueOperation::execute(Executor& executor) const
+Expected<Value*> ValueOperation::tryExecute(Executor& executor) const
 {
-	return value;
+	return &executor.makeTemporary(value);
 }
 
 void ValueOperation::serialize(Serializer& serializer)
@@ -80,33 +89,58 @@ void ValueOperation::serialize(Serializer& serializer)
 	serializer.serialize(value);
 }
 
+void ValueOperation::compile(Compiler& compiler) const
+{
+	compiler.emit(OpCode::Value, compiler.getTarget(), compiler.addConstant(value));
+}
+
 
-TypeBase::Ref ReadOperation::execute(Executor& executor) const
+Expected<Value*> ReadOperation::tryExecute(Executor& executor) const
 {
-	return executor.getContext().get(variableName);
+	executor.recordRead(variable);
+	if (auto* value = executor.getContext().find(variable))
+		return value;
+	return ExecutionError{ ErrorCode::UnsetVariable, variable.name.str().c_str() };
 }
 
 void ReadOperation::serialize(Serializer& serializer)
 {
-	serializer.serialize(variableName);
+	serializer.serialize(variable);
+}
+
+void ReadOperation::compile(Compiler& compiler) const
+{
+	compiler.emit(OpCode::Read, compiler.getTarget(), compiler.addVariable(variable));
 }
 
 
-TypeBase::Ref AssignOperation::execute(Executor& executor) const
+Expected<Value*> AssignOperation::tryExecute(Executor& executor) const
 {
-	return executor.getContext().set(variableName, sourceOperation->execute(executor));
+	auto source = sourceOperation->tryExecute(executor);
+	if (!source)
+		return source;
+	return &executor.getContext().set(variable, **source);
 }
 
 void AssignOperation::serialize(Serializer& serializer)
 {
-	serializer.serialize(variableName);
+	serializer.serialize(variable);
 	serializer.serialize(sourceOperation);
 }
 
+void AssignOperation::compile(Compiler& compiler) const
+{
+	auto target = compiler.compile(*sourceOperation, compiler.getTarget());
+	compiler.emit(OpCode::Assign, target, compiler.addVariable(variable));
+}
 
-TypeBase::Ref CloneOperation::execute(Executor& executor) const
+
+Expected<Value*> CloneOperation::tryExecute(Executor& executor) const
 {
-	return sourceOperation->execute(executor)->clone();
+	auto source = sourceOperation->tryExecute(executor);
+	if (!source)
+		return source;
+	return &executor.makeTemporary(**source);
 }
 
 void CloneOperation::serialize(Serializer& serializer)
@@ -114,10 +148,25 @@ void CloneOperation::serialize(Serializer& serializer)
 	serializer.serialize(sourceOperation);
 }
 
+void CloneOperation::compile(Compiler& compiler) const
+{
+	auto target = compiler.compile(*sourceOperation, compiler.getTarget());
+	compiler.emit(OpCode::Clone, target, target);
+}
+
 
-TypeBase::Ref AddOperation::execute(Executor& executor) const
+Expected<Value*> AddOperation::tryExecute(Executor& executor) const
 {
-	return (*destinationOperation->execute(executor)) += *sourceOperation->execute(executor);
+	auto destination = destinationOperation->tryExecute(executor);
+	if (!destination)
+		return destination;
+	auto source = sourceOperation->tryExecute(executor);
+	if (!source)
+		return source;
+	auto result = (*destination)->tryAdd(**source);
+	if (result)
+		executor.recordChange(**result);
+	return result;
 }
 
 void AddOperation::serialize(Serializer& serializer)
@@ -126,6 +175,221 @@ void AddOperation::serialize(Serializer& serializer)
 	serializer.serialize(sourceOperation);
 }
 
+void AddOperation::compile(Compiler& compiler) const
+{
+	auto target = compiler.compile(*destinationOperation, compiler.getTarget());
+	auto source = compiler.compile(*sourceOperation, target + 1);
+	compiler.emit(OpCode::Add, target, source);
+}
+
+
+template <typename D, typename S> TypedAddOperation<D, S>::TypedAddOperation(Operation::Ref destination, Operation::Ref source) noexcept
+	: destinationOperation(std::move(destination)), sourceOperation(std::move(source))
+{}
+
+template <typename D, typename S> Expected<Value*> TypedAddOperation<D, S>::tryExecute(Executor& executor) const
+{
+	auto destination = destinationOperation->tryExecute(executor);
+	if (!destination)
+		return destination;
+	auto source = sourceOperation->tryExecute(executor);
+	if (!source)
+		return source;
+	auto& destinationValue = **destination;
+	const auto& sourceValue = **source;
+	if constexpr (std::is_same_v<D, IntValue>)
+		destinationValue.intValue += sourceValue.intValue;
+	else if constexpr (std::is_same_v<S, IntValue>)
+		destinationValue.floatValue += FloatValue(sourceValue.intValue);
+	else
+		destinationValue.floatValue += sourceValue.floatValue;
+	executor.recordChange(destinationValue);
+	return &destinationValue;
+}
+
+template <typename D, typename S> void TypedAddOperation<D, S>::serialize(Serializer& serializer)
+{
+	serializer.serialize(destinationOperation);
+	serializer.serialize(sourceOperation);
+}
+
+template <typename D, typename S> void TypedAddOperation<D, S>::compile(Compiler& compiler) const
+{
+	auto target = compiler.compile(*destinationOperation, compiler.getTarget());
+	auto source = compiler.compile(*sourceOperation, target + 1);
+	compiler.emit(OpCode::Add, target, source);
+}
+
+template class TypedAddOperation<IntValue, IntValue>;
+template class TypedAddOperation<FloatValue, IntValue>;
+template class TypedAddOperation<FloatValue, FloatValue>;
+
+
+Expected<Value*> RangeOperation::tryExecute(Executor& executor) const
+{
+	Value begin, end, step;
+	if (auto error = getBounds(executor, begin, end, step))
+		return error;
+	auto array = makeArray(begin, end, step);
+	if (!array)
+		return array.getError();
+	return &executor.makeTemporary(std::move(*array));
+}
+
+void RangeOperation::serialize(Serializer& serializer)
+{
+	serializer.serialize(beginOperation);
+	serializer.serialize(endOperation);
+	serializer.serialize(stepOperation);
+}
+
+void RangeOperation::compile(Compiler& compiler) const
+{
+	compiler.emit(OpCode::Execute, compiler.getTarget(), compiler.addOperation(*this));
+}
+
+ExecutionError RangeOperation::getBounds(Executor& executor, Value& begin, Value& end, Value& step) const
+{
+	const std::pair<const Operation*, Value*> bounds[] = { { beginOperation.get(), &begin }, { endOperation.get(), &end },
+		{ stepOperation.get(), &step } };
+	for (const auto& [operation, bound] : bounds)
+	{
+		auto result = operation->tryExecute(executor);
+		if (!result)
+			return result.getError();
+		*bound = **result;
+	}
+	return {};
+}
+
+Expected<std::size_t> RangeOperation::getIntCount(IntValue begin, IntValue end, IntValue step) noexcept
+{
+	if (step == 0)
+		return ExecutionError{ ErrorCode::InvalidOperation, TypeInt::id().getName(), "Range with zero step" };
+	if (step > 0 ? begin >= end : begin <= end)
+		return 0;
+	auto distance = step > 0 ? std::uint64_t(end) - std::uint64_t(begin) : std::uint64_t(begin) - std::uint64_t(end);
+	auto stride = step > 0 ? std::uint64_t(step) : std::uint64_t(0) - std::uint64_t(step);
+	return std::size_t((distance - 1) / stride + 1);
+}
+
+static FloatValue getRangeFloat(const Value& bound)
+{
+	return bound.getKind() == Value::Kind::Int ? FloatValue(bound.as<IntValue>()) : bound.as<FloatValue>();
+}
+
+Expected<Value> RangeOperation::makeArray(const Value& begin, const Value& end, const Value& step)
+{
+	if (begin.getKind() == Value::Kind::Int && end.getKind() == Value::Kind::Int && step.getKind() == Value::Kind::Int)
+	{
+		auto first = begin.as<IntValue>(), stride = step.as<IntValue>();
+		auto count = getIntCount(first, end.as<IntValue>(), stride);
+		if (!count)
+			return count.getError();
+		if (*count > maxArraySize)
+			return ExecutionError{ ErrorCode::InvalidOperation, TypeInt::id().getName(), "Range with too many elements" };
+		auto array = TypeArray::create(NumericArray::ElementKind::Int, *count);
+		auto* elements = array->get().getInts();
+		for (std::size_t i = 0; i < array->get().size(); ++i)
+			elements[i] = IntValue(std::uint64_t(first) + std::uint64_t(i) * std::uint64_t(stride));
+		return Value{ std::move(array) };
+	}
+
+	for (const auto* bound : { &begin, &end, &step })
+		if (bound->getKind() != Value::Kind::Int && bound->getKind() != Value::Kind::Float)
+			return ExecutionError{ ErrorCode::InvalidTypeCast, bound->getId().getName(), TypeFloat::id().getName() };
+	auto first = getRangeFloat(begin), last = getRangeFloat(end), stride = getRangeFloat(step);
+	if (stride == 0)
+		return ExecutionError{ ErrorCode::InvalidOperation, TypeFloat::id().getName(), "Range with zero step" };
+	// infinite or NaN counts, e.g. from huge bounds or tiny steps, do not convert to a size
+	auto count = std::ceil((last - first) / stride);
+	if (!std::isfinite(count) || count > FloatValue(maxArraySize))
+		return ExecutionError{ ErrorCode::InvalidOperation, TypeFloat::id().getName(), "Range with too many elements" };
+	auto array = TypeArray::create(NumericArray::ElementKind::Float, count > 0 ? std::size_t(count) : 0);
+	auto* elements = array->get().getFloats();
+	for (std::size_t i = 0; i < array->get().size(); ++i)
+		elements[i] = first + FloatValue(i) * stride;
+	return Value{ std::move(array) };
+}
+
+
+Expected<Value*> ForLoopOperation::tryExecute(Executor& executor) const
+{
+	// ranges are counted through without building their array, also when wrapped (see Profiler)
+	if (const auto* range = dynamic_cast<const RangeOperation*>(&rangeOperation->unwrap()))
+	{
+		Value begin, end, step;
+		if (auto error = range->getBounds(executor, begin, end, step))
+			return error;
+		if (begin.getKind() != Value::Kind::Int || end.getKind() != Value::Kind::Int || step.getKind() != Value::Kind::Int)
+		{
+			auto array = RangeOperation::makeArray(begin, end, step);
+			if (!array)
+				return array.getError();
+			return iterate(executor, array->as<NumericArray>());
+		}
+
+		auto first = begin.as<IntValue>(), stride = step.as<IntValue>();
+		auto count = RangeOperation::getIntCount(first, end.as<IntValue>(), stride);
+		if (!count)
+			return count.getError();
+		auto& context = executor.getContext();
+		auto mark = executor.getTemporaryMark();
+		Value* result = nullptr;
+		for (std::size_t i = 0; i < *count; ++i)
+		{
+			executor.releaseTemporaries(mark);
+			context.set(variable, IntValue(std::uint64_t(first) + std::uint64_t(i) * std::uint64_t(stride)));
+			auto bodyResult = bodyOperation->tryExecute(executor);
+			if (!bodyResult)
+				return bodyResult;
+			result = *bodyResult;
+		}
+		return result ? result : &executor.makeTemporary(Value{});
+	}
+
+	auto elements = rangeOperation->tryExecute(executor);
+	if (!elements)
+		return elements;
+	// shares the array, so that changes made by the body copy it and leave the iterated elements as they were
+	const auto elementsValue = **elements;
+	if (!(elementsValue.getId() == TypeArray::id()))
+		return ExecutionError{ ErrorCode::InvalidOperation, elementsValue.getId().getName(), "Iteration" };
+	return iterate(executor, elementsValue.as<NumericArray>());
+}
+
+Expected<Value*> ForLoopOperation::iterate(Executor& executor, const NumericArray& elements) const
+{
+	auto& context = executor.getContext();
+	auto mark = executor.getTemporaryMark();
+	Value* result = nullptr;
+	for (std::size_t i = 0; i < elements.size(); ++i)
+	{
+		executor.releaseTemporaries(mark);
+		if (elements.getElementKind() == NumericArray::ElementKind::Int)
+			context.set(variable, elements.getInts()[i]);
+		else
+			context.set(variable, elements.getFloats()[i]);
+		auto bodyResult = bodyOperation->tryExecute(executor);
+		if (!bodyResult)
+			return bodyResult;
+		result = *bodyResult;
+	}
+	return result ? result : &executor.makeTemporary(Value{});
+}
+
+void ForLoopOperation::serialize(Serializer& serializer)
+{
+	serializer.serialize(variable);
+	serializer.serialize(rangeOperation);
+	serializer.serialize(bodyOperation);
+}
+
+void ForLoopOperation::compile(Compiler& compiler) const
+{
+	compiler.emit(OpCode::Execute, compiler.getTarget(), compiler.addOperation(*this));
+}
+
 
 /*class SumVisitor : public ElementVisitorFailing
 {
@@ -190,10 +454,4 @@ void Sum::accept(VisitorOld& visitor)
 	visitor.visit(*this);
 }*/
 
-
-/*Element::Ref RangeGenerator::execute()
-{
-	return{};
-}*/
-
 }
\ No newline at end of file
@@ -1,15 +1,18 @@
 #pragma once
 
-#include <CppScript/Types.h>
+#include <CppScript/Value.h>
 
 #include <CppScript/Base.h>
 #include <CppScript/TypeWrapper.h>
+#include <CppScript/Context.h>
 
 namespace CppScript
 {
 
 	class Executor;
 	class Serializer;
+	class Compiler;
+	class NumericArray;
 
 	enum class OperationType
 	{
@@ -18,6 +21,8 @@ namespace CppScript
 		Clone,
 		Assign,
 		Add,
+		Range,
+		ForLoop,
 		Last
 	};
 
@@ -26,8 +31,21 @@ namespace CppScript
 	public:
 		virtual ~Operation() = default;
 
-		virtual TypeBase::Ref execute(Executor& executor) const = 0;
+		// the result of tryExecute, its error thrown
+		Value& execute(Executor& executor) const
+		{
+			return *tryExecute(executor).get();
+		}
+		// script errors are returned instead of thrown, only failures like running out of memory throw
+		virtual Expected<Value*> tryExecute(Executor& executor) const = 0;
 		virtual void serialize(Serializer& serializer) = 0;
+		virtual void compile(Compiler& compiler) const = 0;
+		virtual OperationType getType() const = 0;
+		// the operation doing the work, operations wrapping another one (see Profiler) return the wrapped one
+		virtual const Operation& unwrap() const
+		{
+			return *this;
+		}
 
 		using Ref = std::unique_ptr<Operation>;
 		static Ref create(OperationType opType);
@@ -35,10 +53,10 @@ namespace CppScript
 		static const std::string& getName(OperationType opType);
 	};
 
-	template <OperationType T> class OperationTypeBase
+	template <OperationType T> class OperationTypeBase : public Operation
 	{
 	public:
-		virtual OperationType getType() const
+		virtual OperationType getType() const override
 		{
 			return T;
 		}
@@ -50,64 +68,136 @@ namespace CppScript
 	};
 
 
-	class ValueOperation : public Operation, public OperationTypeBase<OperationType::Value>
+	class ValueOperation : public OperationTypeBase<OperationType::Value>
+	{
+	public:
+		virtual Expected<Value*> tryExecute(Executor& executor) const override;
+		virtual void serialize(Serializer& serializer) override;
+		virtual void compile(Compiler& compiler) const override;
+
+	private:
+		// literals are handed out as copies, which share array literals until they are changed
+		Value value;
+	};
+
+
+	class ReadOperation : public OperationTypeBase<OperationType::Read>
 	{
 	public:
-		virtual TypeBase::Ref execute(Executor& executor) const override;
+		virtual Expected<Value*> tryExecute(Executor& executor) const override;
 		virtual void serialize(Serializer& serializer) override;
+		virtual void compile(Compiler& compiler) const override;
 
 	private:
-		TypeBase::Ref value;
+		Variable variable;
 	};
 
 
-	class ReadOperation : public Operation, public OperationTypeBase<OperationType::Read>
+	class AssignOperation : public OperationTypeBase<OperationType::Assign>
 	{
 	public:
-		virtual TypeBase::Ref execute(Executor& executor) const override;
+		virtual Expected<Value*> tryExecute(Executor& executor) const override;
 		virtual void serialize(Serializer& serializer) override;
+		virtual void compile(Compiler& compiler) const override;
 
 	private:
-		std::string variableName;
+		Variable variable;
+		Operation::Ref sourceOperation;
 	};
 
 
-	class AssignOperation : public Operation, public OperationTypeBase<OperationType::Assign>
+	// The copy shares the object of its source until either of them is changed.
+	class CloneOperation : public OperationTypeBase<OperationType::Clone>
 	{
 	public:
-		virtual TypeBase::Ref execute(Executor& executor) const override;
+		virtual Expected<Value*> tryExecute(Executor& executor) const override;
 		virtual void serialize(Serializer& serializer) override;
+		virtual void compile(Compiler& compiler) const override;
 
 	private:
-		std::string variableName;
 		Operation::Ref sourceOperation;
 	};
 
 
-	class CloneOperation : public Operation, public OperationTypeBase<OperationType::Clone>
+	class AddOperation : public OperationTypeBase<OperationType::Add>
 	{
 	public:
-		virtual TypeBase::Ref execute(Executor& executor) const override;
+		virtual Expected<Value*> tryExecute(Executor& executor) const override;
 		virtual void serialize(Serializer& serializer) override;
+		virtual void compile(Compiler& compiler) const override;
 
 	private:
+		Operation::Ref destinationOperation;
 		Operation::Ref sourceOperation;
 	};
 
 
-	class AddOperation : public Operation, public OperationTypeBase<OperationType::Add>
+	// Addition of operands proven to be of the given types (see TypeInference), it adds the numbers
+	// without dispatching on or checking their types.
+	template <typename D, typename S> class TypedAddOperation : public OperationTypeBase<OperationType::Add>
 	{
 	public:
-		virtual TypeBase::Ref execute(Executor& executor) const override;
+		TypedAddOperation(Operation::Ref destination, Operation::Ref source) noexcept;
+
+		virtual Expected<Value*> tryExecute(Executor& executor) const override;
 		virtual void serialize(Serializer& serializer) override;
+		virtual void compile(Compiler& compiler) const override;
 
 	private:
 		Operation::Ref destinationOperation;
 		Operation::Ref sourceOperation;
 	};
 
+	using AddIntIntOperation = TypedAddOperation<IntValue, IntValue>;
+	using AddFloatIntOperation = TypedAddOperation<FloatValue, IntValue>;
+	using AddFloatFloatOperation = TypedAddOperation<FloatValue, FloatValue>;
+
+	extern template class TypedAddOperation<IntValue, IntValue>;
+	extern template class TypedAddOperation<FloatValue, IntValue>;
+	extern template class TypedAddOperation<FloatValue, FloatValue>;
+
+
+	// Evaluates to an array of the numbers from begin (inclusive) to end (exclusive) by step,
+	// int bounds give an int array, any float bound gives a float array.
+	class RangeOperation : public OperationTypeBase<OperationType::Range>
+	{
+	public:
+		virtual Expected<Value*> tryExecute(Executor& executor) const override;
+		virtual void serialize(Serializer& serializer) override;
+		virtual void compile(Compiler& compiler) const override;
+
+		ExecutionError getBounds(Executor& executor, Value& begin, Value& end, Value& step) const;
+		static Expected<std::size_t> getIntCount(IntValue begin, IntValue end, IntValue step) noexcept;
+		static Expected<Value> makeArray(const Value& begin, const Value& end, const Value& step);
+
+		// ranges built as arrays are limited to this many elements, longer ones are script errors
+		static constexpr std::size_t maxArraySize = std::size_t(1) << 28;
+
+	private:
+		Operation::Ref beginOperation;
+		Operation::Ref endOperation;
+		Operation::Ref stepOperation;
+	};
+
+
+	// Runs the body for every element of the range, assigned to the loop variable, and evaluates
+	// to the last body result. Int ranges are counted directly without building the array,
+	// changing the loop variable in the body does not change the iteration.
+	class ForLoopOperation : public OperationTypeBase<OperationType::ForLoop>
+	{
+	public:
+		virtual Expected<Value*> tryExecute(Executor& executor) const override;
+		virtual void serialize(Serializer& serializer) override;
+		virtual void compile(Compiler& compiler) const override;
+
+	private:
+		Expected<Value*> iterate(Executor& executor, const NumericArray& elements) const;
+
+		Variable variable;
+		Operation::Ref rangeOperation;
+		Operation::Ref bodyOperation;
+	};
 
-	class Context;
 
 	class OperationOld : public Visitable<OperationOld, Element, ElementVisitor>
 	{
@@ -129,18 +219,4 @@ namespace CppScript
 		Elements operands;
 	};
 
-	class Iterator : public OperationOld
-	{
-
-	};
-
-	/*class RangeGenerator : public OperationOld
-	{
-	public:
-		//virtual Ref execute() override;
-
-	protected:
-		//IntValue currentValue;
-	};*/
-
 }
\ No newline at end of file
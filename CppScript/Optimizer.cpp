@@ -0,0 +1,726 @@
+#include <CppScript/Optimizer.h>
+#include <CppScript/Execution.h>
+#include <CppScript/Binary.h>
+#include <CppScript/NumericArray.h>
+
+namespace CppScript
+{
+
+// Collects the direct operand fields of a single operation.
+class OperationFields : public Serializer
+{
+public:
+	explicit OperationFields(Operation& obj)
+	{
+		obj.serialize(*this);
+	}
+
+	void serialize(Operation::Ref& obj) override
+	{
+		operations.push_back(&obj);
+	}
+
+	void serialize(Value& value) override
+	{
+		values.push_back(&value);
+	}
+
+	void serialize(std::string& value) override
+	{}
+
+	void serialize(Variable& value) override
+	{
+		variables.push_back(&value);
+	}
+
+	std::vector<Operation::Ref*> operations;
+	std::vector<Value*> values;
+	std::vector<Variable*> variables;
+};
+
+
+static std::size_t countOperations(Operation::Ref& obj)
+{
+	if (!obj)
+		return 0;
+	std::size_t count = 1;
+	for (auto* operand : OperationFields{ *obj }.operations)
+		count += countOperations(*operand);
+	return count;
+}
+
+static Value* getLiteral(Operation::Ref& obj)
+{
+	if (!obj || obj->getType() != OperationType::Value)
+		return nullptr;
+	return OperationFields{ *obj }.values.front();
+}
+
+// literal, also behind a Clone
+static Value* findLiteral(Operation::Ref& obj)
+{
+	if (obj && obj->getType() == OperationType::Clone)
+		return getLiteral(*OperationFields{ *obj }.operations.front());
+	return getLiteral(obj);
+}
+
+
+void ConstantFolder::serialize(Operation::Ref& obj)
+{
+	if (!obj)
+		return;
+	obj->serialize(*this);
+	switch (obj->getType())
+	{
+	case OperationType::Add:
+		foldAdd(obj);
+		break;
+	case OperationType::Clone:
+		foldClone(obj);
+		break;
+	default:
+		break;
+	}
+}
+
+void ConstantFolder::serialize(Value& value)
+{}
+
+void ConstantFolder::serialize(std::string& value)
+{}
+
+void ConstantFolder::serialize(Variable& value)
+{}
+
+std::size_t ConstantFolder::getRemovedCount() const noexcept
+{
+	return removedCount;
+}
+
+void ConstantFolder::foldAdd(Operation::Ref& obj)
+{
+	OperationFields fields{ *obj };
+	auto& destination = *fields.operations[0];
+	auto& source = *fields.operations[1];
+	auto* destinationLiteral = findLiteral(destination);
+	auto* sourceLiteral = findLiteral(source);
+	if (!destinationLiteral || !sourceLiteral)
+		return;
+
+	auto result = destinationLiteral->clone();
+	try
+	{
+		result += *sourceLiteral;
+	}
+	catch (const std::exception&)
+	{
+		// leave the failing addition to report its error when executed
+		return;
+	}
+	*destinationLiteral = std::move(result);
+	removedCount += 1 + countOperations(source);
+	obj = std::move(destination);
+}
+
+void ConstantFolder::foldClone(Operation::Ref& obj)
+{
+	auto& source = *OperationFields{ *obj }.operations.front();
+	if (!source || source->getType() != OperationType::Clone)
+		return;
+	++removedCount;
+	obj = std::move(source);
+}
+
+
+// Types of expressions and variables form a lattice: the none type for no value yet (a variable
+// not assigned so far, an expression failing on it), a known type, or null for unknown. The type of
+// a variable joins those the tree assigns to it, so reads only take it once an assignment ran.
+
+static const TypeIdBase& noValue()
+{
+	return Value::noneId();
+}
+
+static void collectAssigned(Operation::Ref& obj, std::unordered_map<Symbol, const TypeIdBase*>& variables)
+{
+	if (!obj)
+		return;
+	OperationFields fields{ *obj };
+	if (obj->getType() == OperationType::Assign || obj->getType() == OperationType::ForLoop)
+		variables.try_emplace(fields.variables.front()->name, &noValue());
+	for (auto* operand : fields.operations)
+		collectAssigned(*operand, variables);
+}
+
+// variable the result of an operation refers to, additions into the result change it
+static const Variable* findAliasedVariable(Operation::Ref& obj)
+{
+	if (!obj)
+		return nullptr;
+	OperationFields fields{ *obj };
+	switch (obj->getType())
+	{
+	case OperationType::Read:
+	case OperationType::Assign:
+		return fields.variables.front();
+	case OperationType::Add:
+		return findAliasedVariable(*fields.operations.front());
+	case OperationType::ForLoop:
+		return findAliasedVariable(*fields.operations.back());
+	default:
+		return nullptr;
+	}
+}
+
+static bool isBasicType(const TypeIdBase* type)
+{
+	return type == &TypeInt::id() || type == &TypeFloat::id() || type == &TypeBool::id() || type == &TypeArray::id();
+}
+
+static const TypeIdBase* getAddType(const TypeIdBase* destination, const TypeIdBase* source)
+{
+	if (destination == &noValue() || source == &noValue())
+		return &noValue();
+	if (destination == &TypeInt::id() && source == &TypeInt::id())
+		return &TypeInt::id();
+	if (destination == &TypeFloat::id() && (source == &TypeInt::id() || source == &TypeFloat::id()))
+		return &TypeFloat::id();
+	if (destination == &TypeArray::id() && (source == &TypeInt::id() || source == &TypeFloat::id() || source == &TypeArray::id()))
+		return &TypeArray::id();
+	return nullptr;
+}
+
+
+void TypeInference::declare(Symbol name, const TypeIdBase& type)
+{
+	declared[name] = &type;
+}
+
+void TypeInference::serialize(Operation::Ref& obj)
+{
+	if (depth > 0)
+	{
+		infer(obj);
+		return;
+	}
+	// assignments only ever widen the types of variables, so this ends once they stop changing
+	variables = declared;
+	collectAssigned(obj, variables);
+	do
+	{
+		changed = false;
+		types.clear();
+		assignedNames.clear();
+		infer(obj);
+	} while (changed);
+	specialize(obj);
+}
+
+void TypeInference::serialize(Value& value)
+{}
+
+void TypeInference::serialize(std::string& value)
+{}
+
+void TypeInference::serialize(Variable& value)
+{}
+
+const TypeIdBase* TypeInference::getType(const Operation& operation) const
+{
+	auto typePos = types.find(&operation);
+	if (typePos == types.end() || typePos->second == &noValue())
+		return nullptr;
+	return typePos->second;
+}
+
+std::size_t TypeInference::getSpecializedCount() const noexcept
+{
+	return specializedCount;
+}
+
+void TypeInference::infer(Operation::Ref& obj)
+{
+	if (!obj)
+		return;
+	++depth;
+	if (obj->getType() == OperationType::ForLoop)
+	{
+		// the loop variable is assigned in the body only, which may not run
+		OperationFields loop{ *obj };
+		infer(*loop.operations[0]);
+		auto assignedBefore = assignedNames;
+		assignedNames.insert(loop.variables.front()->name);
+		infer(*loop.operations[1]);
+		assignedNames = std::move(assignedBefore);
+	}
+	else
+		obj->serialize(*this);
+	--depth;
+
+	OperationFields fields{ *obj };
+	auto operandType = [&](std::size_t index) -> const TypeIdBase*
+	{
+		auto typePos = types.find(fields.operations[index]->get());
+		return typePos != types.end() ? typePos->second : nullptr;
+	};
+	const TypeIdBase* type = nullptr;
+	switch (obj->getType())
+	{
+	case OperationType::Value:
+		type = &fields.values.front()->getId();
+		break;
+	case OperationType::Read:
+	{
+		// values the host set are only known for declared variables
+		const auto& name = fields.variables.front()->name;
+		auto variablePos = variables.find(name);
+		if (variablePos != variables.end() && (declared.count(name) > 0 || assignedNames.count(name) > 0))
+			type = variablePos->second;
+		break;
+	}
+	case OperationType::Clone:
+		type = operandType(0);
+		break;
+	case OperationType::Assign:
+		type = operandType(0);
+		assign(*fields.variables.front(), type);
+		assignedNames.insert(fields.variables.front()->name);
+		break;
+	case OperationType::Add:
+		type = getAddType(operandType(0), operandType(1));
+		// objects of other types may replace themselves when added to
+		if (!isBasicType(operandType(0)) && operandType(0) != &noValue())
+			if (const auto* variable = findAliasedVariable(*fields.operations[0]))
+				assign(*variable, nullptr);
+		break;
+	case OperationType::Range:
+		type = &TypeArray::id();
+		break;
+	case OperationType::ForLoop:
+		assign(*fields.variables.front(), getElementType(*fields.operations[0]));
+		break;
+	default:
+		break;
+	}
+	types[obj.get()] = type;
+}
+
+const TypeIdBase* TypeInference::getElementType(Operation::Ref& range) const
+{
+	if (!range)
+		return nullptr;
+	OperationFields fields{ *range };
+	if (range->getType() == OperationType::Value)
+	{
+		const auto& literal = *fields.values.front();
+		if (!(literal.getId() == TypeArray::id()))
+			return nullptr;
+		if (literal.as<NumericArray>().getElementKind() == NumericArray::ElementKind::Int)
+			return &TypeInt::id();
+		return &TypeFloat::id();
+	}
+	if (range->getType() != OperationType::Range)
+		return nullptr;
+
+	// int bounds give ints, any float bound gives floats
+	const TypeIdBase* elementType = &TypeInt::id();
+	for (auto* bound : fields.operations)
+	{
+		auto typePos = types.find(bound->get());
+		const auto* boundType = typePos != types.end() ? typePos->second : nullptr;
+		if (boundType == &noValue())
+			return &noValue();
+		if (boundType == &TypeFloat::id())
+			elementType = &TypeFloat::id();
+		else if (boundType != &TypeInt::id())
+			return nullptr;
+	}
+	return elementType;
+}
+
+void TypeInference::assign(const Variable& variable, const TypeIdBase* type)
+{
+	auto& variableType = variables[variable.name];
+	if (!variableType || type == &noValue() || variableType == type)
+		return;
+	variableType = variableType == &noValue() ? type : nullptr;
+	changed = true;
+}
+
+void TypeInference::specialize(Operation::Ref& obj)
+{
+	if (!obj)
+		return;
+	OperationFields fields{ *obj };
+	for (auto* operand : fields.operations)
+		specialize(*operand);
+	if (obj->getType() != OperationType::Add)
+		return;
+
+	auto& destination = *fields.operations[0];
+	auto& source = *fields.operations[1];
+	if (!destination || !source)
+		return;
+	const auto* destinationType = getType(*destination);
+	const auto* sourceType = getType(*source);
+	Operation::Ref typed;
+	if (destinationType == &TypeInt::id() && sourceType == &TypeInt::id())
+		typed = std::make_unique<AddIntIntOperation>(std::move(destination), std::move(source));
+	else if (destinationType == &TypeFloat::id() && sourceType == &TypeInt::id())
+		typed = std::make_unique<AddFloatIntOperation>(std::move(destination), std::move(source));
+	else if (destinationType == &TypeFloat::id() && sourceType == &TypeFloat::id())
+		typed = std::make_unique<AddFloatFloatOperation>(std::move(destination), std::move(source));
+	else
+		return;
+	types[typed.get()] = types[obj.get()];
+	types.erase(obj.get());
+	obj = std::move(typed);
+	++specializedCount;
+}
+
+
+// Stands in for the operations it fuses, everything but execution is passed to them.
+class FusedOperation : public Operation
+{
+public:
+	explicit FusedOperation(Operation::Ref op) : operation(std::move(op))
+	{}
+
+	void serialize(Serializer& serializer) override
+	{
+		operation->serialize(serializer);
+	}
+
+	void compile(Compiler& compiler) const override
+	{
+		operation->compile(compiler);
+	}
+
+	OperationType getType() const override
+	{
+		return operation->getType();
+	}
+
+protected:
+	static Expected<Value*> find(Executor& executor, const Variable& variable)
+	{
+		executor.recordRead(variable);
+		if (auto* value = executor.getContext().find(variable))
+			return value;
+		return ExecutionError{ ErrorCode::UnsetVariable, variable.name.str().c_str() };
+	}
+
+	static Expected<Value*> recordChange(Executor& executor, Expected<Value*> result)
+	{
+		if (result)
+			executor.recordChange(**result);
+		return result;
+	}
+
+private:
+	Operation::Ref operation;
+};
+
+class IncrementOperation : public FusedOperation
+{
+public:
+	IncrementOperation(Operation::Ref op, const Variable& var, const Value& increment)
+		: FusedOperation(std::move(op)), variable(var), constant(increment)
+	{}
+
+	Expected<Value*> tryExecute(Executor& executor) const override
+	{
+		auto value = find(executor, variable);
+		if (!value)
+			return value;
+		return recordChange(executor, (*value)->tryAdd(constant));
+	}
+
+private:
+	const Variable& variable;
+	const Value& constant;
+};
+
+class AddVariablesOperation : public FusedOperation
+{
+public:
+	AddVariablesOperation(Operation::Ref op, const Variable& destinationVariable, const Variable& sourceVariable)
+		: FusedOperation(std::move(op)), destination(destinationVariable), source(sourceVariable)
+	{}
+
+	Expected<Value*> tryExecute(Executor& executor) const override
+	{
+		auto destinationValue = find(executor, destination);
+		if (!destinationValue)
+			return destinationValue;
+		auto sourceValue = find(executor, source);
+		if (!sourceValue)
+			return sourceValue;
+		return recordChange(executor, (*destinationValue)->tryAdd(**sourceValue));
+	}
+
+private:
+	const Variable& destination;
+	const Variable& source;
+};
+
+class CloneAssignOperation : public FusedOperation
+{
+public:
+	CloneAssignOperation(Operation::Ref op, const Variable& destinationVariable, const Variable& sourceVariable)
+		: FusedOperation(std::move(op)), destination(destinationVariable), source(sourceVariable)
+	{}
+
+	Expected<Value*> tryExecute(Executor& executor) const override
+	{
+		auto sourceValue = find(executor, source);
+		if (!sourceValue)
+			return sourceValue;
+		return &executor.getContext().set(destination, **sourceValue);
+	}
+
+private:
+	const Variable& destination;
+	const Variable& source;
+};
+
+
+// the variable of a Read, null for other operations
+static const Variable* getReadVariable(Operation::Ref& obj)
+{
+	if (!obj || obj->getType() != OperationType::Read)
+		return nullptr;
+	return OperationFields{ *obj }.variables.front();
+}
+
+void OperationFuser::serialize(Operation::Ref& obj)
+{
+	if (!obj || dynamic_cast<FusedOperation*>(obj.get()))
+		return;
+	if (!fuse(obj))
+		obj->serialize(*this);
+}
+
+void OperationFuser::serialize(Value& value)
+{}
+
+void OperationFuser::serialize(std::string& value)
+{}
+
+void OperationFuser::serialize(Variable& value)
+{}
+
+const FusionStatistics& OperationFuser::getStatistics() const noexcept
+{
+	return statistics;
+}
+
+bool OperationFuser::fuse(Operation::Ref& obj)
+{
+	OperationFields fields{ *obj };
+	switch (obj->getType())
+	{
+	case OperationType::Assign:
+	{
+		auto& source = *fields.operations.front();
+		if (!source)
+			return false;
+		OperationFields sourceFields{ *source };
+		if (source->getType() == OperationType::Add)
+		{
+			const auto* variable = getReadVariable(*sourceFields.operations[0]);
+			auto* constant = getLiteral(*sourceFields.operations[1]);
+			if (!variable || !constant || variable->name != fields.variables.front()->name)
+				return false;
+			obj = std::make_unique<IncrementOperation>(std::move(obj), *variable, *constant);
+			++statistics.increments;
+			return true;
+		}
+		if (source->getType() == OperationType::Clone)
+		{
+			const auto* variable = getReadVariable(*sourceFields.operations.front());
+			if (!variable)
+				return false;
+			auto& destination = *fields.variables.front();
+			obj = std::make_unique<CloneAssignOperation>(std::move(obj), destination, *variable);
+			++statistics.cloneAssignments;
+			return true;
+		}
+		return false;
+	}
+	case OperationType::Add:
+	{
+		const auto* destination = getReadVariable(*fields.operations[0]);
+		const auto* source = getReadVariable(*fields.operations[1]);
+		if (!destination || !source)
+			return false;
+		obj = std::make_unique<AddVariablesOperation>(std::move(obj), *destination, *source);
+		++statistics.variableAdditions;
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+
+// Runs the unoptimized copy of a tree on a clone of the context before running the tree itself.
+class VerifiedOperation : public Operation
+{
+public:
+	VerifiedOperation(Operation::Ref op, Operation::Ref originalOp) : operation(std::move(op)), original(std::move(originalOp))
+	{}
+
+	Expected<Value*> tryExecute(Executor& executor) const override
+	{
+		auto& context = executor.getContext();
+		auto expectedContext = context.clone();
+		Executor expectedExecutor{ expectedContext };
+		auto expected = original->tryExecute(expectedExecutor);
+		auto result = operation->tryExecute(executor);
+
+		if (bool(expected) != bool(result) || (!result && expected.getError().getCode() != result.getError().getCode()))
+			throw OptimizationMismatch{ "optimized tree fails differently" };
+		if (result && !isSame(*expected, *result))
+			throw OptimizationMismatch{ "optimized tree evaluates to a different value" };
+		auto names = expectedContext.getNames();
+		auto resultNames = context.getNames();
+		names.insert(names.end(), resultNames.begin(), resultNames.end());
+		for (const auto& name : names)
+			if (!isSame(expectedContext.find(Variable{ name }), context.find(Variable{ name })))
+				throw OptimizationMismatch{ "optimized tree leaves variable " + name.str() + " different" };
+		return result;
+	}
+
+	void serialize(Serializer& serializer) override
+	{
+		operation->serialize(serializer);
+	}
+
+	void compile(Compiler& compiler) const override
+	{
+		operation->compile(compiler);
+	}
+
+	OperationType getType() const override
+	{
+		return operation->getType();
+	}
+
+private:
+	static bool isSame(const Value* left, const Value* right)
+	{
+		if (!left || !right)
+			return left == right;
+		return left->getId() == right->getId() && *left == *right;
+	}
+
+	Operation::Ref operation;
+	Operation::Ref original;
+};
+
+
+// temporary made by the operation itself, so that nothing else refers to it
+static bool isTemporary(Operation::Ref& obj)
+{
+	if (!obj)
+		return false;
+	switch (obj->getType())
+	{
+	case OperationType::Value:
+	case OperationType::Clone:
+	case OperationType::Range:
+		return true;
+	case OperationType::Add:
+		return isTemporary(*OperationFields{ *obj }.operations.front());
+	default:
+		return false;
+	}
+}
+
+// variable a clone of the operation would copy
+static const Variable* findClonedVariable(Operation::Ref& obj)
+{
+	if (obj && obj->getType() == OperationType::Clone)
+		return findClonedVariable(*OperationFields{ *obj }.operations.front());
+	return findAliasedVariable(obj);
+}
+
+CloneElider::CloneElider(bool verifyResults) noexcept : verifying(verifyResults)
+{}
+
+void CloneElider::serialize(Operation::Ref& obj)
+{
+	if (!obj)
+		return;
+	Operation::Ref original;
+	if (verifying)
+	{
+		BinaryWriter writer;
+		writer.serialize(obj);
+		auto image = writer.getData();
+		BinaryLoader loader{ image.data(), image.size() };
+		loader.serialize(original);
+	}
+	elide(obj, Use::Kept);
+	if (verifying)
+		obj = std::make_unique<VerifiedOperation>(std::move(obj), std::move(original));
+}
+
+void CloneElider::serialize(Value& value)
+{}
+
+void CloneElider::serialize(std::string& value)
+{}
+
+void CloneElider::serialize(Variable& value)
+{}
+
+std::size_t CloneElider::getRemovedCount() const noexcept
+{
+	return removedCount;
+}
+
+void CloneElider::elide(Operation::Ref& obj, Use use)
+{
+	if (!obj)
+		return;
+	OperationFields fields{ *obj };
+	switch (obj->getType())
+	{
+	case OperationType::Add:
+	{
+		// adding a variable to itself reads what it changes
+		auto& destination = *fields.operations[0];
+		auto& source = *fields.operations[1];
+		const auto* destinationVariable = findAliasedVariable(destination);
+		const auto* sourceVariable = findClonedVariable(source);
+		auto sourceUse = destinationVariable && sourceVariable && destinationVariable->name == sourceVariable->name ? Use::Kept : Use::Read;
+		elide(destination, Use::Kept);
+		elide(source, sourceUse);
+		break;
+	}
+	case OperationType::Range:
+		// bounds are copied as they are evaluated
+		for (auto* bound : fields.operations)
+			elide(*bound, Use::Read);
+		break;
+	case OperationType::Clone:
+	{
+		auto& source = *fields.operations.front();
+		elide(source, Use::Read);
+		if (source && (use == Use::Read || isTemporary(source)))
+		{
+			obj = std::move(source);
+			++removedCount;
+		}
+		break;
+	}
+	default:
+		for (auto* operand : fields.operations)
+			elide(*operand, Use::Kept);
+		break;
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <CppScript/Serializer.h>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+
+namespace CppScript
+{
+
+	// Folds constant subtrees of a loaded operation tree: additions of literals, cloned or not, become
+	// the literal of their result, which stays behind the Clone of the destination if it had one.
+	class ConstantFolder : public Serializer
+	{
+	public:
+		virtual void serialize(Operation::Ref& obj) override;
+
+		virtual void serialize(Value& value) override;
+		virtual void serialize(std::string& value) override;
+		virtual void serialize(Variable& value) override;
+
+		std::size_t getRemovedCount() const noexcept;
+
+	private:
+		void foldAdd(Operation::Ref& obj);
+		void foldClone(Operation::Ref& obj);
+
+		std::size_t removedCount{ 0 };
+	};
+
+
+	// Infers the type every operation of a tree evaluates to, from its literals and the declared types
+	// of variables, and replaces additions of proven int and float operands by typed ones.
+	// A variable is of a known type when its declared type and the types of all assignments in the tree
+	// agree. Variables assigned by the tree are taken as its own: unless declared, they must not hold
+	// values of other types when it runs. Variables only read by the tree are of unknown type unless declared.
+	class TypeInference : public Serializer
+	{
+	public:
+		// the variable holds a value of the type whenever the tree runs
+		void declare(Symbol name, const TypeIdBase& type);
+
+		virtual void serialize(Operation::Ref& obj) override;
+
+		virtual void serialize(Value& value) override;
+		virtual void serialize(std::string& value) override;
+		virtual void serialize(Variable& value) override;
+
+		// inferred type of an operation of the last tree, null when unknown
+		const TypeIdBase* getType(const Operation& operation) const;
+		std::size_t getSpecializedCount() const noexcept;
+
+	private:
+		void infer(Operation::Ref& obj);
+		const TypeIdBase* getElementType(Operation::Ref& range) const;
+		void assign(const Variable& variable, const TypeIdBase* type);
+		void specialize(Operation::Ref& obj);
+
+		std::unordered_map<Symbol, const TypeIdBase*> declared;
+		std::unordered_map<Symbol, const TypeIdBase*> variables;
+		std::unordered_map<const Operation*, const TypeIdBase*> types;
+		// variables assigned on every path to the operation inferred, reads of others may see host values
+		std::unordered_set<Symbol> assignedNames;
+		std::size_t depth{ 0 };
+		bool changed{ false };
+		std::size_t specializedCount{ 0 };
+	};
+
+
+	struct FusionStatistics
+	{
+		// Assign(x, Add(Read x, Value c)), incrementing x in place
+		std::size_t increments{ 0 };
+		// Add(Read a, Read b)
+		std::size_t variableAdditions{ 0 };
+		// Assign(y, Clone(Read x)), cloning x straight into y
+		std::size_t cloneAssignments{ 0 };
+	};
+
+
+	// Replaces common operation shapes by single fused operations. The fused operations keep the
+	// replaced ones, which they serialize and compile as, so run this last: passes replacing
+	// operands of a fused operation would leave it executing the removed ones.
+	class OperationFuser : public Serializer
+	{
+	public:
+		virtual void serialize(Operation::Ref& obj) override;
+
+		virtual void serialize(Value& value) override;
+		virtual void serialize(std::string& value) override;
+		virtual void serialize(Variable& value) override;
+
+		const FusionStatistics& getStatistics() const noexcept;
+
+	private:
+		bool fuse(Operation::Ref& obj);
+
+		FusionStatistics statistics;
+	};
+
+
+	// Reported by verifying optimizers when the optimized tree behaves differently from the original.
+	class OptimizationMismatch : public std::logic_error
+	{
+	public:
+		using std::logic_error::logic_error;
+	};
+
+
+	// Removes clones that cannot be told apart from their sources: clones whose value is only read
+	// right away (added to a destination, taken as a range bound, cloned again), and clones of
+	// temporaries nothing else refers to (literals, clones, ranges and additions into them).
+	// When verifying, the tree keeps an unoptimized copy, which every execution first runs on a clone
+	// of the context; differing results or variables throw OptimizationMismatch.
+	class CloneElider : public Serializer
+	{
+	public:
+		explicit CloneElider(bool verifyResults = false) noexcept;
+
+		virtual void serialize(Operation::Ref& obj) override;
+
+		virtual void serialize(Value& value) override;
+		virtual void serialize(std::string& value) override;
+		virtual void serialize(Variable& value) override;
+
+		std::size_t getRemovedCount() const noexcept;
+
+	private:
+		enum class Use
+		{
+			Kept,		// stored, changed or handed out
+			Read		// read before anything else runs
+		};
+
+		void elide(Operation::Ref& obj, Use use);
+
+		const bool verifying;
+		std::size_t removedCount{ 0 };
+	};
+
+}
\ No newline at end of file
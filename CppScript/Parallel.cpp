@@ -0,0 +1,200 @@
+#include <CppScript/Parallel.h>
+#include <algorithm>
+#include <chrono>
+
+namespace CppScript
+{
+
+double WorkerStatistics::getThroughput() const noexcept
+{
+	return busySeconds > 0 ? double(records) / busySeconds : 0;
+}
+
+
+WorkStealingPool::WorkStealingPool(std::size_t workerCount)
+{
+	if (workerCount == 0)
+		workerCount = std::max(1u, std::thread::hardware_concurrency());
+	for (std::size_t worker = 0; worker < workerCount; ++worker)
+		queues.push_back(std::make_unique<TaskQueue>());
+	statistics.resize(workerCount);
+	for (std::size_t worker = 0; worker < workerCount; ++worker)
+		threads.emplace_back([this, worker]() { work(worker); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		std::lock_guard<std::mutex> lock{ stateMutex };
+		stopping = true;
+	}
+	started.notify_all();
+	for (auto& thread : threads)
+		thread.join();
+}
+
+std::size_t WorkStealingPool::getWorkerCount() const noexcept
+{
+	return threads.size();
+}
+
+void WorkStealingPool::run(std::vector<Task> tasks)
+{
+	if (tasks.empty())
+		return;
+	std::unique_lock<std::mutex> lock{ stateMutex };
+	currentTasks = std::move(tasks);
+	std::fill(statistics.begin(), statistics.end(), WorkerStatistics{});
+	auto taskCount = currentTasks.size();
+	auto workerCount = queues.size();
+	for (std::size_t worker = 0; worker < workerCount; ++worker)
+	{
+		std::lock_guard<std::mutex> queueLock{ queues[worker]->mutex };
+		for (auto task = worker * taskCount / workerCount; task < (worker + 1) * taskCount / workerCount; ++task)
+			queues[worker]->tasks.push_back(task);
+	}
+	remainingTasks = taskCount;
+	cancelled = false;
+	error = nullptr;
+	++generation;
+	started.notify_all();
+	finished.wait(lock, [this]() { return remainingTasks == 0; });
+	currentTasks.clear();
+	if (error)
+		std::rethrow_exception(std::exchange(error, nullptr));
+}
+
+const std::vector<WorkerStatistics>& WorkStealingPool::getStatistics() const noexcept
+{
+	return statistics;
+}
+
+void WorkStealingPool::work(std::size_t worker)
+{
+	std::size_t seenGeneration = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock{ stateMutex };
+			started.wait(lock, [&]() { return stopping || generation != seenGeneration; });
+			if (stopping)
+				return;
+			seenGeneration = generation;
+		}
+
+		auto& workerStatistics = statistics[worker];
+		std::size_t task;
+		bool stolen;
+		while (takeTask(worker, task, stolen))
+		{
+			bool skip;
+			{
+				std::lock_guard<std::mutex> lock{ stateMutex };
+				skip = cancelled;
+			}
+			if (!skip)
+			{
+				auto startTime = std::chrono::steady_clock::now();
+				try
+				{
+					workerStatistics.records += currentTasks[task](worker);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock{ stateMutex };
+					if (!error)
+						error = std::current_exception();
+					cancelled = true;
+				}
+				workerStatistics.busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+				++workerStatistics.tasks;
+				if (stolen)
+					++workerStatistics.stolenTasks;
+			}
+
+			std::lock_guard<std::mutex> lock{ stateMutex };
+			if (--remainingTasks == 0)
+				finished.notify_all();
+		}
+	}
+}
+
+bool WorkStealingPool::takeTask(std::size_t worker, std::size_t& task, bool& stolen)
+{
+	{
+		auto& queue = *queues[worker];
+		std::lock_guard<std::mutex> lock{ queue.mutex };
+		if (!queue.tasks.empty())
+		{
+			task = queue.tasks.front();
+			queue.tasks.pop_front();
+			stolen = false;
+			return true;
+		}
+	}
+	for (std::size_t offset = 1; offset < queues.size(); ++offset)
+	{
+		auto& queue = *queues[(worker + offset) % queues.size()];
+		std::lock_guard<std::mutex> lock{ queue.mutex };
+		if (!queue.tasks.empty())
+		{
+			task = queue.tasks.back();
+			queue.tasks.pop_back();
+			stolen = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+ParallelRunner::ParallelRunner(const Operation& op, const Context& prototype, std::size_t workerCount)
+	: operation(op), pool(workerCount)
+{
+	for (std::size_t worker = 0; worker < pool.getWorkerCount(); ++worker)
+		workers.push_back(std::make_unique<Worker>(prototype));
+}
+
+void ParallelRunner::setChunkSize(std::size_t size) noexcept
+{
+	chunkSize = std::max<std::size_t>(size, 1);
+}
+
+std::vector<Value> ParallelRunner::run(const std::vector<std::string>& inputNames, const std::vector<Record>& records)
+{
+	// bind the inputs once per run, so records set their values by slot instead of by name
+	for (auto& worker : workers)
+	{
+		worker->inputSlots.clear();
+		for (const auto& name : inputNames)
+			worker->inputSlots.push_back(worker->context.getSlot(name));
+	}
+
+	std::vector<Value> results(records.size());
+	std::vector<WorkStealingPool::Task> tasks;
+	for (std::size_t first = 0; first < records.size(); first += chunkSize)
+	{
+		auto last = std::min(first + chunkSize, records.size());
+		tasks.push_back([this, first, last, &records, &results](std::size_t workerIndex)
+			{
+				auto& worker = *workers[workerIndex];
+				for (auto row = first; row < last; ++row)
+				{
+					const auto& record = records[row];
+					for (std::size_t input = 0; input < record.size() && input < worker.inputSlots.size(); ++input)
+						worker.context.set(worker.inputSlots[input], record[input]);
+					results[row] = worker.executor.execute(operation);
+				}
+				return last - first;
+			});
+	}
+	pool.run(std::move(tasks));
+	return results;
+}
+
+const std::vector<WorkerStatistics>& ParallelRunner::getStatistics() const noexcept
+{
+	return pool.getStatistics();
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <CppScript/Execution.h>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CppScript
+{
+
+struct WorkerStatistics
+{
+	std::size_t tasks{ 0 };
+	std::size_t stolenTasks{ 0 };
+	std::size_t records{ 0 };
+	double busySeconds{ 0 };
+
+	double getThroughput() const noexcept;
+};
+
+
+// Fixed set of worker threads, each with its own task queue. A worker takes tasks from the front
+// of its own queue and, once it runs dry, steals from the back of the other queues.
+class WorkStealingPool
+{
+public:
+	// a task returns the number of records it processed
+	using Task = std::function<std::size_t(std::size_t worker)>;
+
+	explicit WorkStealingPool(std::size_t workerCount = 0);
+	~WorkStealingPool();
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	std::size_t getWorkerCount() const noexcept;
+
+	// Runs all tasks and waits for them, consecutive tasks start on the same worker.
+	// The first exception thrown by a task cancels the remaining ones and is rethrown here.
+	void run(std::vector<Task> tasks);
+
+	const std::vector<WorkerStatistics>& getStatistics() const noexcept;
+
+private:
+	struct TaskQueue
+	{
+		std::mutex mutex;
+		std::deque<std::size_t> tasks;
+	};
+
+	void work(std::size_t worker);
+	bool takeTask(std::size_t worker, std::size_t& task, bool& stolen);
+
+	std::vector<std::unique_ptr<TaskQueue>> queues;
+	std::vector<WorkerStatistics> statistics;
+	std::vector<Task> currentTasks;
+
+	std::mutex stateMutex;
+	std::condition_variable started;
+	std::condition_variable finished;
+	std::size_t generation{ 0 };
+	std::size_t remainingTasks{ 0 };
+	bool cancelled{ false };
+	bool stopping{ false };
+	std::exception_ptr error;
+
+	std::vector<std::thread> threads;
+};
+
+
+// Runs one shared operation tree for many input records on a work-stealing pool.
+// Every worker executes in its own copy of the prototype context, so the operation has to be
+// resolved against the prototype (or left unresolved). The tree itself is only read, the copies
+// of its literals and of the prototype's values share their objects until a worker changes them.
+class ParallelRunner
+{
+public:
+	using Record = std::vector<Value>;
+
+	ParallelRunner(const Operation& operation, const Context& prototype, std::size_t workerCount = 0);
+
+	void setChunkSize(std::size_t size) noexcept;
+
+	// Records hold the values of the input names in order, results come back in record order.
+	std::vector<Value> run(const std::vector<std::string>& inputNames, const std::vector<Record>& records);
+
+	const std::vector<WorkerStatistics>& getStatistics() const noexcept;
+
+private:
+	struct Worker
+	{
+		explicit Worker(const Context& prototype) : context(prototype), executor(context)
+		{}
+
+		Context context;
+		Executor executor;
+		std::vector<Context::Slot> inputSlots;
+	};
+
+	const Operation& operation;
+	std::size_t chunkSize{ 256 };
+	WorkStealingPool pool;
+	std::vector<std::unique_ptr<Worker>> workers;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include <CppScript/Profiler.h>
+#include <CppScript/Execution.h>
+#include <CppScript/Memory.h>
+#include <algorithm>
+#include <iomanip>
+
+namespace CppScript
+{
+
+// Stands in for an operation of an instrumented tree, everything but execution is passed through.
+class ProfiledOperation : public Operation
+{
+public:
+	explicit ProfiledOperation(Operation::Ref op) : operation(std::move(op))
+	{}
+
+	Expected<Value*> tryExecute(Executor& executor) const override
+	{
+		auto* profiler = executor.getProfiler();
+		if (!profiler)
+			return operation->tryExecute(executor);
+		profiler->enter();
+		try
+		{
+			auto result = operation->tryExecute(executor);
+			profiler->leave(*operation);
+			return result;
+		}
+		catch (...)
+		{
+			profiler->leave(*operation);
+			throw;
+		}
+	}
+
+	void serialize(Serializer& serializer) override
+	{
+		operation->serialize(serializer);
+	}
+
+	void compile(Compiler& compiler) const override
+	{
+		operation->compile(compiler);
+	}
+
+	OperationType getType() const override
+	{
+		return operation->getType();
+	}
+
+	const Operation& unwrap() const override
+	{
+		return operation->unwrap();
+	}
+
+	Operation::Ref operation;
+};
+
+
+class Instrumenter : public Serializer
+{
+public:
+	void serialize(Operation::Ref& obj) override
+	{
+		if (!obj)
+			return;
+		obj->serialize(*this);
+		if (!dynamic_cast<ProfiledOperation*>(obj.get()))
+			obj = std::make_unique<ProfiledOperation>(std::move(obj));
+	}
+
+	void serialize(Value& value) override
+	{}
+	void serialize(std::string& value) override
+	{}
+	void serialize(Variable& value) override
+	{}
+};
+
+
+class Stripper : public Serializer
+{
+public:
+	void serialize(Operation::Ref& obj) override
+	{
+		if (!obj)
+			return;
+		if (auto* profiled = dynamic_cast<ProfiledOperation*>(obj.get()))
+			obj = std::move(profiled->operation);
+		obj->serialize(*this);
+	}
+
+	void serialize(Value& value) override
+	{}
+	void serialize(std::string& value) override
+	{}
+	void serialize(Variable& value) override
+	{}
+};
+
+
+void Profiler::instrument(Operation::Ref& operation)
+{
+	Instrumenter instrumenter;
+	instrumenter.serialize(operation);
+}
+
+void Profiler::strip(Operation::Ref& operation)
+{
+	Stripper stripper;
+	stripper.serialize(operation);
+}
+
+void Profiler::enter()
+{
+	frames.push_back({ std::chrono::steady_clock::now(), std::chrono::nanoseconds{ 0 }, TypePool::getStatistics().allocations, 0 });
+}
+
+void Profiler::leave(const Operation& operation)
+{
+	auto inclusiveTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - frames.back().start);
+	auto allocations = TypePool::getStatistics().allocations - frames.back().startAllocations;
+	auto& profile = profiles[&operation];
+	profile.operation = &operation;
+	++profile.calls;
+	profile.inclusiveTime += inclusiveTime;
+	profile.exclusiveTime += inclusiveTime - frames.back().childTime;
+	profile.allocations += allocations - frames.back().childAllocations;
+	frames.pop_back();
+	if (!frames.empty())
+	{
+		frames.back().childTime += inclusiveTime;
+		frames.back().childAllocations += allocations;
+	}
+}
+
+const OperationProfile* Profiler::getProfile(const Operation& operation) const
+{
+	auto profilePos = profiles.find(&operation);
+	return profilePos != profiles.end() ? &profilePos->second : nullptr;
+}
+
+std::vector<OperationProfile> Profiler::getTop(std::size_t count) const
+{
+	std::vector<OperationProfile> top;
+	top.reserve(profiles.size());
+	for (const auto& profile : profiles)
+		top.push_back(profile.second);
+	count = std::min(count, top.size());
+	std::partial_sort(top.begin(), top.begin() + count, top.end(), [](const OperationProfile& left, const OperationProfile& right)
+		{ return left.exclusiveTime > right.exclusiveTime; });
+	top.resize(count);
+	return top;
+}
+
+void Profiler::report(std::ostream& output, std::size_t count, const SourceMap* sources) const
+{
+	output << std::left << std::setw(10) << "operation" << std::right << std::setw(10) << "calls" << std::setw(16) << "inclusive ns"
+		<< std::setw(16) << "exclusive ns" << std::setw(12) << "allocations" << "  source\n";
+	for (const auto& profile : getTop(count))
+	{
+		output << std::left << std::setw(10) << Operation::getName(profile.operation->getType()) << std::right << std::setw(10) << profile.calls
+			<< std::setw(16) << profile.inclusiveTime.count() << std::setw(16) << profile.exclusiveTime.count()
+			<< std::setw(12) << profile.allocations << "  ";
+		auto sourcePos = sources ? sources->find(profile.operation) : SourceMap::const_iterator{};
+		if (sources && sourcePos != sources->end())
+		{
+			output << '#' << sourcePos->second.pointer;
+			if (sourcePos->second.offset != SourcePosition::unknownOffset)
+				output << " @" << sourcePos->second.offset;
+		}
+		output << '\n';
+	}
+}
+
+void Profiler::reset()
+{
+	profiles.clear();
+	frames.clear();
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <CppScript/Serializer.h>
+#include <chrono>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+
+namespace CppScript
+{
+
+	struct OperationProfile
+	{
+		const Operation* operation{ nullptr };
+		std::size_t calls{ 0 };
+		std::chrono::nanoseconds inclusiveTime{ 0 };
+		std::chrono::nanoseconds exclusiveTime{ 0 };
+		// object allocations made by the operation itself, not by its operands
+		std::size_t allocations{ 0 };
+	};
+
+
+	// Measures the operations of instrumented trees while it is set on the executing Executor.
+	// Trees that are not instrumented run exactly as before, instrumented ones only check for
+	// a profiler while none is set. Bytecode programs are measured where they run tree operations.
+	class Profiler
+	{
+	public:
+		// wraps every operation of the tree, so that its executions can be measured
+		static void instrument(Operation::Ref& operation);
+		// removes the wrappers added by instrument
+		static void strip(Operation::Ref& operation);
+
+		const OperationProfile* getProfile(const Operation& operation) const;
+		// profiles ordered by exclusive time, the hottest first
+		std::vector<OperationProfile> getTop(std::size_t count) const;
+		// table of the top operations, with their source positions when known
+		void report(std::ostream& output, std::size_t count, const SourceMap* sources = nullptr) const;
+		void reset();
+
+	private:
+		friend class ProfiledOperation;
+
+		struct Frame
+		{
+			std::chrono::steady_clock::time_point start;
+			std::chrono::nanoseconds childTime;
+			std::size_t startAllocations;
+			std::size_t childAllocations;
+		};
+
+		void enter();
+		void leave(const Operation& operation);
+
+		std::unordered_map<const Operation*, OperationProfile> profiles;
+		std::vector<Frame> frames;
+	};
+
+}
\ No newline at end of file
@@ -1,28 +1,23 @@
 #include <CppScript/Serializer.h>
 #include <CppScript/BasicTypes.h>
+#include <CppScript/NumericArray.h>
+#include <algorithm>
+#include <stdexcept>
 
 namespace CppScript
 {
 
-class NotBaseType : public std::exception
+NotBaseType::NotBaseType(const char* typeName) noexcept : typeName(typeName)
 {
-public:
-	NotBaseType(const char* typeName) noexcept : typeName(typeName)
-	{
-		std::ostringstream messageStream;
-		messageStream << "Type: " << typeName << " is not a basic type, therefore cannot be serialized";
-		message = messageStream.str();
-	}
-
-	virtual const char* what() const noexcept
-	{
-		return message.c_str();
-	}
+	std::ostringstream messageStream;
+	messageStream << "Type: " << typeName << " is not a basic type, therefore cannot be serialized";
+	message = messageStream.str();
+}
 
-private:
-	const char* typeName;
-	std::string message;
-};
+const char* NotBaseType::what() const noexcept
+{
+	return message.c_str();
+}
 
 
 class JsonArrayLoader : public JsonLoader
@@ -34,58 +29,135 @@ public:
 protected:
 	const Json& getData() override
 	{
+		++fieldIndex;
 		return *currentData++;
 	}
 
+	std::string getPath() const override
+	{
+		return JsonLoader::getPath() + '/' + std::to_string(fieldIndex - 1);
+	}
+
 private:
 	Json::const_iterator currentData;
+	std::size_t fieldIndex{ 0 };
 };
 
 
 JsonLoader::JsonLoader(const Json& data) : operationData(data)
 {}
 
+void JsonLoader::setSourceMap(SourceMap& map)
+{
+	sourceMap = &map;
+}
+
 void JsonLoader::serialize(Operation::Ref& obj)
 {
 	const auto& data = getData();
-	obj = Operation::create(data["type"].get<std::string>());
-	if (obj)
+	const auto& opType = data["type"].get_ref<const std::string&>();
+	obj = Operation::create(opType);
+	if (!obj)
+		throw std::invalid_argument{ "Unknown operation type: " + opType };
+	auto opPath = sourceMap ? getPath() : std::string{};
+	if (sourceMap)
+		(*sourceMap)[obj.get()] = { opPath };
+	loadData(*obj, data["data"], opPath + "/data");
+}
+
+void JsonLoader::loadData(Operation& obj, const Json& data, const std::string& dataPath)
+{
+	// an array given to a Value operation is its literal, not its field list
+	if (data.is_array() && obj.getType() != OperationType::Value)
+	{
+		JsonArrayLoader opLoader{ data };
+		opLoader.sourceMap = sourceMap;
+		opLoader.path = dataPath;
+		obj.serialize(opLoader);
+	}
+	else
 	{
-		const auto& opData = data["data"];
-		if (opData.is_array())
-		{
-			JsonArrayLoader opLoader{ opData };
-			obj->serialize(opLoader);
-		}
-		else
-		{
-			JsonLoader opLoader{ opData };
-			obj->serialize(opLoader);
-		}
+		JsonLoader opLoader{ data };
+		opLoader.sourceMap = sourceMap;
+		opLoader.path = dataPath;
+		obj.serialize(opLoader);
 	}
 }
 
-void JsonLoader::serialize(TypeBase::Ref& value)
+void JsonLoader::serialize(Value& value)
 {
 	const auto& data = getData();
 	if (data.is_number_integer())
-		value = TypeInt::create(data.get<TypeInt::ValueType>());
+		value = data.get<TypeInt::ValueType>();
 	else if (data.is_number_float())
-		value = TypeFloat::create(data.get<TypeFloat::ValueType>());
+		value = data.get<TypeFloat::ValueType>();
 	else if (data.is_boolean())
-		value = data.get<bool>() ? TypeBool::trueValue : TypeBool::falseValue;
+		value = data.get<bool>();
+	else if (data.is_array())
+		value = loadArray(data);
 	else
 		throw NotBaseType{ data.type_name() };
 }
 
+Value JsonLoader::loadArray(const Json& data)
+{
+	auto isFloat = false;
+	for (const auto& element : data)
+		if (element.is_number_float())
+			isFloat = true;
+		else if (!element.is_number_integer())
+			throw NotBaseType{ element.type_name() };
+
+	if (!isFloat)
+	{
+		auto array = TypeArray::create(NumericArray::ElementKind::Int, data.size());
+		std::transform(data.begin(), data.end(), array->get().getInts(), [](const Json& element) { return element.get<IntValue>(); });
+		return array;
+	}
+	auto array = TypeArray::create(NumericArray::ElementKind::Float, data.size());
+	std::transform(data.begin(), data.end(), array->get().getFloats(), [](const Json& element) { return element.get<FloatValue>(); });
+	return array;
+}
+
 void JsonLoader::serialize(std::string& value)
 {
 	value = getData().get<std::string>();
 }
 
+void JsonLoader::serialize(Variable& value)
+{
+	value.name = getData().get_ref<const std::string&>();
+}
+
 const Json& JsonLoader::getData()
 {
 	return operationData;
 }
 
+std::string JsonLoader::getPath() const
+{
+	return path;
+}
+
+
+VariableResolver::VariableResolver(Context& cntx) : context(cntx)
+{}
+
+void VariableResolver::serialize(Operation::Ref& obj)
+{
+	if (obj)
+		obj->serialize(*this);
+}
+
+void VariableResolver::serialize(Value& value)
+{}
+
+void VariableResolver::serialize(std::string& value)
+{}
+
+void VariableResolver::serialize(Variable& value)
+{
+	value.slot = context.getSlot(value.name);
+}
+
 }
\ No newline at end of file
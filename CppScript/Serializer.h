@@ -1,12 +1,27 @@
 #pragma once
 
-#include <CppScript/Types.h>
+#include <CppScript/Value.h>
 #include <CppScript/Operations.h>
 #include <CppScript/Json.h>
+#include <limits>
+#include <unordered_map>
 
 namespace CppScript
 {
 
+	class NotBaseType : public std::exception
+	{
+	public:
+		NotBaseType(const char* typeName) noexcept;
+
+		virtual const char* what() const noexcept override;
+
+	private:
+		const char* typeName;
+		std::string message;
+	};
+
+
 	class Serializer
 	{
 	public:
@@ -14,25 +29,65 @@ namespace CppScript
 
 		virtual void serialize(Operation::Ref& obj) = 0;
 
-		virtual void serialize(TypeBase::Ref& value) = 0;
+		virtual void serialize(Value& value) = 0;
 		virtual void serialize(std::string& value) = 0;
+		virtual void serialize(Variable& value) = 0;
 	};
 
 
+	// Where a loaded operation came from: the JSON pointer of its object and, when the loader reads
+	// characters, the offset of its opening brace.
+	struct SourcePosition
+	{
+		std::string pointer;
+		std::size_t offset{ unknownOffset };
+
+		static constexpr std::size_t unknownOffset = std::numeric_limits<std::size_t>::max();
+	};
+
+	using SourceMap = std::unordered_map<const Operation*, SourcePosition>;
+
+
 	class JsonLoader : public Serializer
 	{
 	public:
 		JsonLoader(const Json& data);
 
+		// records the position of every operation loaded afterwards
+		void setSourceMap(SourceMap& map);
+
 		virtual void serialize(Operation::Ref& obj) override;
 
-		virtual void serialize(TypeBase::Ref& value) override;
+		virtual void serialize(Value& value) override;
 		virtual void serialize(std::string& value) override;
+		virtual void serialize(Variable& value) override;
 
 	protected:
 		virtual const Json& getData();
+		virtual std::string getPath() const;
 
 	private:
+		static Value loadArray(const Json& data);
+		void loadData(Operation& obj, const Json& data, const std::string& dataPath);
+
 		const Json& operationData;
+		SourceMap* sourceMap{ nullptr };
+		std::string path;
+	};
+
+
+	class VariableResolver : public Serializer
+	{
+	public:
+		explicit VariableResolver(Context& cntx);
+
+		virtual void serialize(Operation::Ref& obj) override;
+
+		virtual void serialize(Value& value) override;
+		virtual void serialize(std::string& value) override;
+		virtual void serialize(Variable& value) override;
+
+	private:
+		Context& context;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include <CppScript/Symbol.h>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace CppScript
+{
+
+class SymbolTable
+{
+public:
+	static SymbolTable& get()
+	{
+		static SymbolTable table;
+		return table;
+	}
+
+	const Symbol::Entry* find(std::string_view name)
+	{
+		std::shared_lock<std::shared_mutex> lock{ mutex };
+		auto entryPos = index.find(name);
+		return entryPos != index.end() ? entryPos->second : nullptr;
+	}
+
+	const Symbol::Entry* intern(std::string_view name)
+	{
+		if (const auto* entry = find(name))
+			return entry;
+		std::unique_lock<std::shared_mutex> lock{ mutex };
+		auto entryPos = index.find(name);
+		if (entryPos != index.end())
+			return entryPos->second;
+		entries.push_back({ std::string{ name }, std::hash<std::string_view>{}(name), std::uint32_t(entries.size()) });
+		const auto* entry = &entries.back();
+		index.emplace(entry->name, entry);
+		return entry;
+	}
+
+private:
+	std::shared_mutex mutex;
+	// a deque keeps the entries, and the names the index views, in place
+	std::deque<Symbol::Entry> entries;
+	std::unordered_map<std::string_view, const Symbol::Entry*> index;
+};
+
+
+Symbol::Symbol() : Symbol(std::string_view{})
+{}
+
+Symbol::Symbol(std::string_view name) : entry(SymbolTable::get().intern(name))
+{}
+
+std::optional<Symbol> Symbol::find(std::string_view name)
+{
+	if (const auto* entry = SymbolTable::get().find(name))
+		return Symbol{ entry };
+	return std::nullopt;
+}
+
+}
\ No newline at end of file
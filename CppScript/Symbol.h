@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+namespace CppScript
+{
+
+	// Name interned in a process wide table: its text is stored and hashed once, symbols compare
+	// by pointer. Interned names live until the process ends.
+	class Symbol
+	{
+	public:
+		Symbol();
+		Symbol(std::string_view name);
+		Symbol(const std::string& name) : Symbol(std::string_view{ name })
+		{}
+		Symbol(const char* name) : Symbol(std::string_view{ name })
+		{}
+
+		// the symbol of an already interned name, without interning it
+		static std::optional<Symbol> find(std::string_view name);
+
+		const std::string& str() const noexcept
+		{
+			return entry->name;
+		}
+
+		std::size_t getHash() const noexcept
+		{
+			return entry->hash;
+		}
+
+		// dense ids in interning order
+		std::uint32_t getId() const noexcept
+		{
+			return entry->id;
+		}
+
+		bool operator==(const Symbol& other) const noexcept
+		{
+			return entry == other.entry;
+		}
+
+		bool operator!=(const Symbol& other) const noexcept
+		{
+			return entry != other.entry;
+		}
+
+	private:
+		friend class SymbolTable;
+
+		struct Entry
+		{
+			std::string name;
+			std::size_t hash;
+			std::uint32_t id;
+		};
+
+		explicit Symbol(const Entry* symbolEntry) noexcept : entry(symbolEntry)
+		{}
+
+		const Entry* entry;
+	};
+
+}
+
+
+namespace std
+{
+
+	template <> struct hash<CppScript::Symbol>
+	{
+		std::size_t operator()(const CppScript::Symbol& symbol) const noexcept
+		{
+			return symbol.getHash();
+		}
+	};
+
+}
\ No newline at end of file
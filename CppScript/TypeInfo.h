@@ -9,9 +9,16 @@ namespace CppScript
 	{
 		static std::string getTypeName()
 		{
+#ifdef _MSC_VER
 			constexpr auto prefixSize = sizeof("CppScript::TypeNameHelper<") - 1;
 			constexpr auto postfixSize = sizeof(">::getTypeName");
 			return { __FUNCTION__, prefixSize, sizeof(__FUNCTION__) - prefixSize - postfixSize };
+#else
+			// "... [with T = name; ...]" from GCC, "... [T = name]" from Clang
+			std::string signature{ __PRETTY_FUNCTION__ };
+			auto nameBegin = signature.find("T = ") + sizeof("T = ") - 1;
+			return signature.substr(nameBegin, signature.find_first_of(";]", nameBegin) - nameBegin);
+#endif
 		}
 	};
 
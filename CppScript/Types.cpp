@@ -3,19 +3,24 @@
 namespace CppScript
 {
 
-class InvalidOperation : public std::exception
+std::uint32_t TypeIdBase::nextIndex() noexcept
 {
-public:
-	InvalidOperation(const char* typeName, const char* opName) noexcept;
+	static std::atomic<std::uint32_t> typeCount{ 0 };
+	return typeCount++;
+}
 
-	virtual const char* what() const noexcept override;
 
-private:
-	const char* typeName;
-	const char* operationName;
-	std::string message;
-};
+TypeBase::Ref TypeBase::getRef()
+{
+	if (getReferenceCount() == 0)
+		throw std::bad_weak_ptr{};
+	return Ref{ this };
+}
 
+bool TypeBase::isClonable() const noexcept
+{
+	return false;
+}
 
 TypeBase::Ref TypeBase::clone() const
 {
@@ -37,31 +42,4 @@ bool TypeBase::operator<(const TypeBase& obj) const
 	throw InvalidOperation{ getId().getName(), "Less" };
 }
 
-
-	InvalidOperation::InvalidOperation(const char* typeName, const char* opName) noexcept
-		: typeName(typeName), operationName(opName)
-	{
-		std::ostringstream messageStream;
-		messageStream << "Type: " << typeName << ": " << operationName << " is not supported";
-		message = messageStream.str();
-	}
-
-	const char* InvalidOperation::what() const noexcept
-	{
-		return message.c_str();
-	}
-
-
-	InvalidTypeCast::InvalidTypeCast(const char* fromType, const char* toType) noexcept
-		: fromTypeName(fromType), toTypeName(toType)
-	{
-		std::ostringstream messageStream;
-		messageStream << "Cannot cast from: " << fromTypeName << " to: " << toTypeName;
-		message = messageStream.str();
-	}
-
-	const char* InvalidTypeCast::what() const noexcept
-	{
-		return message.c_str();
-	}
 }
\ No newline at end of file
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <limits>
 #include <memory>
 #include <string>
 #include <sstream>
 #include <optional>
+#include <CppScript/Memory.h>
+#include <CppScript/Error.h>
 
 
 namespace CppScript
@@ -12,7 +15,7 @@ namespace CppScript
 	class TypeIdBase
 	{
 	public:
-		TypeIdBase(const char* name) noexcept : typeName(name)
+		TypeIdBase(const char* name) noexcept : typeName(name), typeIndex(nextIndex())
 		{}
 
 		bool operator==(const TypeIdBase& other) const
@@ -24,24 +27,57 @@ namespace CppScript
 		{
 			return typeName;
 		}
+
+		// dense index of the type, every type id gets the next one as it is constructed
+		std::uint32_t getIndex() const noexcept
+		{
+			return typeIndex;
+		}
 		
 	protected:
 		const char* typeName;
+		std::uint32_t typeIndex;
+
+	private:
+		static std::uint32_t nextIndex() noexcept;
 	};
 
 
+	// Numeric profile of script values, selected per build. Floats are double unless
+	// CPPSCRIPT_FLOAT_SINGLE (float) or CPPSCRIPT_FLOAT_EXTENDED (long double) is defined.
+	// Promotion rules: an int operand is converted to FloatValue when combined with a float,
+	// a float is never narrowed implicitly into an int, and host floating types are converted
+	// to FloatValue on entry and checked for range when read back through as<>.
 	using IntValue = long long;
+#if defined(CPPSCRIPT_FLOAT_SINGLE)
+	using FloatValue = float;
+#elif defined(CPPSCRIPT_FLOAT_EXTENDED)
 	using FloatValue = long double;
+#else
+	using FloatValue = double;
+#endif
 	using BoolValue = const bool;
 
 
-	class TypeBase : public std::enable_shared_from_this<TypeBase>
+	class TypeBase : public RefCounted
 	{
 	public:
-		using Ref = std::shared_ptr<TypeBase>;
+		using Ref = RefPtr<TypeBase>;
 
 		virtual ~TypeBase() noexcept = default;
 
+		static void* operator new(std::size_t size)
+		{
+			return TypePool::allocate(size);
+		}
+
+		static void operator delete(void* block, std::size_t size) noexcept
+		{
+			TypePool::deallocate(block, size);
+		}
+
+		Ref getRef();
+
 		virtual const TypeIdBase& getId() const = 0;
 
 		template<typename T> std::enable_if_t<std::is_class_v<T>, T&> as();
@@ -52,6 +88,9 @@ namespace CppScript
 		template<typename T> std::enable_if_t<std::is_floating_point_v<T>, T> as() const;
 		template<typename T> std::enable_if_t<std::is_same_v<T, BoolValue>, T> as() const;
 
+		// types overriding clone report it here, objects that cannot be cloned stay shared by the values
+		// holding them (see Value::makeUnique)
+		virtual bool isClonable() const noexcept;
 		virtual TypeBase::Ref clone() const;
 		virtual TypeBase::Ref operator+=(const TypeBase& obj);
 
@@ -60,17 +99,21 @@ namespace CppScript
 	};
 
 
-	class InvalidTypeCast : public std::exception
+	class InvalidTypeCast : public ScriptException
 	{
 	public:
-		InvalidTypeCast(const char* fromType, const char* toType) noexcept;
+		InvalidTypeCast(const char* fromType, const char* toType) noexcept
+			: ScriptException({ ErrorCode::InvalidTypeCast, fromType, toType })
+		{}
+	};
 
-		virtual const char* what() const noexcept override;
 
-	private:
-		const char* fromTypeName;
-		const char* toTypeName;
-		std::string message;
+	class InvalidOperation : public ScriptException
+	{
+	public:
+		InvalidOperation(const char* typeName, const char* opName) noexcept
+			: ScriptException({ ErrorCode::InvalidOperation, typeName, opName })
+		{}
 	};
 
 
@@ -134,11 +177,11 @@ namespace CppScript
 			return typeId;
 		}
 
-		using Ref = std::shared_ptr<Type<T>>;
+		using Ref = RefPtr<Type<T>>;
 
 		template<typename ...Args> static Ref create(Args... args)
 		{
-			return std::make_shared<Type<T>>(args...);
+			return Ref{ new Type<T>(args...) };
 		}
 
 	private:
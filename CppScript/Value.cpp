@@ -0,0 +1,144 @@
+#include <CppScript/Value.h>
+#include <CppScript/Dispatch.h>
+
+namespace CppScript
+{
+
+static const TypeIdBase noneTypeId{ "none" };
+
+
+Value::Value(TypeBase::Ref obj) : kind(Kind::None), intValue(0)
+{
+	if (!obj)
+		return;
+	const auto& id = obj->getId();
+	if (id == TypeInt::id())
+		*this = Value{ TypeInt::id().get(*obj) };
+	else if (id == TypeFloat::id())
+		*this = Value{ TypeFloat::id().get(*obj) };
+	else if (id == TypeBool::id())
+		*this = Value{ bool(TypeBool::id().get(*obj)) };
+	else
+	{
+		new (&object) TypeBase::Ref{ std::move(obj) };
+		kind = Kind::Object;
+	}
+}
+
+const TypeIdBase& Value::getId() const
+{
+	switch (kind)
+	{
+	case Kind::Int:
+		return TypeInt::id();
+	case Kind::Float:
+		return TypeFloat::id();
+	case Kind::Bool:
+		return TypeBool::id();
+	case Kind::Object:
+		return object->getId();
+	default:
+		return noneTypeId;
+	}
+}
+
+std::uint32_t Value::getTypeIndex() const
+{
+	return getId().getIndex();
+}
+
+const TypeBase::Ref& Value::getObject() const
+{
+	static const TypeBase::Ref noObject;
+	return kind == Kind::Object ? object : noObject;
+}
+
+TypeBase::Ref Value::box() const
+{
+	switch (kind)
+	{
+	case Kind::Int:
+		return TypeInt::create(intValue);
+	case Kind::Float:
+		return TypeFloat::create(floatValue);
+	case Kind::Bool:
+		return boolValue ? TypeBool::trueValue : TypeBool::falseValue;
+	case Kind::Object:
+		return object;
+	default:
+		return {};
+	}
+}
+
+void Value::makeUnique()
+{
+	if (isShared() && object->isClonable())
+		object = object->clone();
+}
+
+Value Value::clone() const
+{
+	if (kind == Kind::Object)
+		return Value{ object->clone() };
+	return *this;
+}
+
+Value& Value::operator+=(const Value& obj)
+{
+	return *tryAdd(obj).get();
+}
+
+Expected<Value> Value::tryClone() const
+{
+	if (kind != Kind::Object)
+		return *this;
+	try
+	{
+		return Value{ object->clone() };
+	}
+	catch (const ScriptException& exception)
+	{
+		return exception.getError();
+	}
+}
+
+Expected<Value*> Value::tryAdd(const Value& obj)
+{
+	return OperatorTables::getAdd().get(getTypeIndex(), obj.getTypeIndex())(*this, obj);
+}
+
+bool Value::operator==(const Value& obj) const
+{
+	return OperatorTables::getEqual().get(getTypeIndex(), obj.getTypeIndex())(*this, obj);
+}
+
+bool Value::operator<(const Value& obj) const
+{
+	return OperatorTables::getLess().get(getTypeIndex(), obj.getTypeIndex())(*this, obj);
+}
+
+const TypeIdBase& Value::noneId()
+{
+	return noneTypeId;
+}
+
+void Value::throwInvalidCast(const TypeIdBase& toType) const
+{
+	throw InvalidTypeCast{ getId().getName(), toType.getName() };
+}
+
+const IntValue& Value::getInt() const
+{
+	if (kind != Kind::Int)
+		throwInvalidCast(TypeInt::id());
+	return intValue;
+}
+
+const FloatValue& Value::getFloat() const
+{
+	if (kind != Kind::Float)
+		throwInvalidCast(TypeFloat::id());
+	return floatValue;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <CppScript/BasicTypes.h>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+
+namespace CppScript
+{
+
+	class Value
+	{
+	public:
+		enum class Kind : std::uint8_t
+		{
+			None,
+			Int,
+			Float,
+			Bool,
+			Object
+		};
+
+		Value() noexcept : kind(Kind::None), intValue(0)
+		{}
+		Value(IntValue val) noexcept : kind(Kind::Int), intValue(val)
+		{}
+		Value(FloatValue val) noexcept : kind(Kind::Float), floatValue(val)
+		{}
+		Value(bool val) noexcept : kind(Kind::Bool), boolValue(val)
+		{}
+		template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<std::remove_cv_t<T>, bool>
+			&& !std::is_same_v<T, IntValue>, int> = 0> Value(T val) noexcept : Value(IntValue(val))
+		{}
+		template <typename T, std::enable_if_t<std::is_floating_point_v<T> && !std::is_same_v<T, FloatValue>, int> = 0>
+			Value(T val) noexcept : Value(FloatValue(val))
+		{}
+		Value(TypeBase::Ref obj);
+		template <typename T, std::enable_if_t<std::is_base_of_v<TypeBase, T>, int> = 0> Value(RefPtr<T> obj)
+			: Value(TypeBase::Ref{ std::move(obj) })
+		{}
+
+		Value(const Value& other) : kind(Kind::None)
+		{
+			copyFrom(other);
+		}
+
+		Value(Value&& other) noexcept : kind(Kind::None)
+		{
+			moveFrom(std::move(other));
+		}
+
+		~Value()
+		{
+			reset();
+		}
+
+		Value& operator=(const Value& other)
+		{
+			if (this != &other)
+			{
+				reset();
+				copyFrom(other);
+			}
+			return *this;
+		}
+
+		Value& operator=(Value&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				moveFrom(std::move(other));
+			}
+			return *this;
+		}
+
+		Kind getKind() const noexcept
+		{
+			return kind;
+		}
+
+		bool isNone() const noexcept
+		{
+			return kind == Kind::None;
+		}
+
+		const TypeIdBase& getId() const;
+		std::uint32_t getTypeIndex() const;
+		const TypeBase::Ref& getObject() const;
+		TypeBase::Ref box() const;
+
+		template<typename T> std::enable_if_t<std::is_class_v<T>, T&> as();
+		template<typename T> std::enable_if_t<std::is_class_v<T>, const T&> as() const;
+
+		template<typename T> std::enable_if_t<std::is_same_v<T, IntValue> || std::is_same_v<T, FloatValue>, T&> as();
+		template<typename T> std::enable_if_t<std::numeric_limits<T>::is_integer && !std::is_same_v<T, BoolValue>, T> as() const;
+		template<typename T> std::enable_if_t<std::is_floating_point_v<T>, T> as() const;
+		template<typename T> std::enable_if_t<std::is_same_v<T, BoolValue>, T> as() const;
+
+		// Objects are shared by copies of a value and copied by the first change made through a shared one.
+		// Changing an object through a reference from getObject bypasses this. Objects of types that cannot
+		// be cloned are never copied, a change made through one value is seen by all values sharing it.
+		bool isShared() const noexcept
+		{
+			return kind == Kind::Object && object->isShared();
+		}
+		void makeUnique();
+
+		Value clone() const;
+		Value& operator+=(const Value& obj);
+		// report script errors instead of throwing them
+		Expected<Value> tryClone() const;
+		Expected<Value*> tryAdd(const Value& obj);
+
+		bool operator==(const Value& obj) const;
+		bool operator<(const Value& obj) const;
+
+		static const TypeIdBase& noneId();
+
+	private:
+		friend class BasicKernels;
+		friend class NativeCode;
+		template <typename D, typename S> friend class TypedAddOperation;
+
+		[[noreturn]] void throwInvalidCast(const TypeIdBase& toType) const;
+
+		const IntValue& getInt() const;
+		const FloatValue& getFloat() const;
+
+		void copyFrom(const Value& other)
+		{
+			if (other.kind == Kind::Object)
+				new (&object) TypeBase::Ref{ other.object };
+			else
+				std::memcpy(static_cast<void*>(&floatValue), &other.floatValue, scalarSize);
+			kind = other.kind;
+		}
+
+		void moveFrom(Value&& other) noexcept
+		{
+			kind = other.kind;
+			if (kind == Kind::Object)
+			{
+				new (&object) TypeBase::Ref{ std::move(other.object) };
+				other.reset();
+			}
+			else
+				std::memcpy(static_cast<void*>(&floatValue), &other.floatValue, scalarSize);
+		}
+
+		void reset() noexcept
+		{
+			if (kind == Kind::Object)
+				std::destroy_at(&object);
+			kind = Kind::None;
+		}
+
+		// bytes of the widest scalar member, copied whatever the scalar kind
+		static constexpr std::size_t scalarSize = sizeof(IntValue) > sizeof(FloatValue) ? sizeof(IntValue) : sizeof(FloatValue);
+
+		Kind kind;
+		union
+		{
+			IntValue intValue;
+			FloatValue floatValue;
+			bool boolValue;
+			TypeBase::Ref object;
+		};
+	};
+
+
+	template<typename T> std::enable_if_t<std::is_class_v<T>, T&> Value::as()
+	{
+		if (kind != Kind::Object)
+			throwInvalidCast(Type<T>::id());
+		makeUnique();
+		return object->as<T>();
+	}
+
+	template<typename T> std::enable_if_t<std::is_class_v<T>, const T&> Value::as() const
+	{
+		if (kind != Kind::Object)
+			throwInvalidCast(Type<T>::id());
+		return static_cast<const TypeBase&>(*object).as<T>();
+	}
+
+	template<typename T> std::enable_if_t<std::is_same_v<T, IntValue> || std::is_same_v<T, FloatValue>, T&> Value::as()
+	{
+		if constexpr (std::is_same_v<T, IntValue>)
+			return const_cast<IntValue&>(getInt());
+		else
+			return const_cast<FloatValue&>(getFloat());
+	}
+
+	template<typename T> std::enable_if_t<std::numeric_limits<T>::is_integer && !std::is_same_v<T, BoolValue>, T> Value::as() const
+	{
+		const auto& value = getInt();
+		if (value < std::numeric_limits<T>::lowest() || value > std::numeric_limits<T>::max())
+			throw ValueOverflow<T, TypeInt::ValueType>{value};
+		return T(value);
+	}
+
+	template<typename T> std::enable_if_t<std::is_floating_point_v<T>, T> Value::as() const
+	{
+		const auto& value = getFloat();
+		if (value < std::numeric_limits<T>::lowest() || value > std::numeric_limits<T>::max())
+			throw ValueOverflow<T, TypeFloat::ValueType>{value};
+		return T(value);
+	}
+
+	template<typename T> std::enable_if_t<std::is_same_v<T, BoolValue>, T> Value::as() const
+	{
+		if (kind != Kind::Bool)
+			throwInvalidCast(TypeBool::id());
+		return boolValue;
+	}
+
+}
\ No newline at end of file
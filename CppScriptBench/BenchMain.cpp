@@ -0,0 +1,24 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <vector>
+
+// Same as benchmark_main, but reports JSON unless a format is chosen, so runs can be diffed between commits.
+int main(int argc, char** argv)
+{
+	std::vector<char*> arguments{ argv, argv + argc };
+	bool hasFormat = false;
+	for (int i = 1; i < argc; ++i)
+		if (std::strncmp(argv[i], "--benchmark_format", sizeof("--benchmark_format") - 1) == 0)
+			hasFormat = true;
+	char jsonFormat[] = "--benchmark_format=json";
+	if (!hasFormat)
+		arguments.push_back(jsonFormat);
+	auto argumentCount = int(arguments.size());
+
+	benchmark::Initialize(&argumentCount, arguments.data());
+	if (benchmark::ReportUnrecognizedArguments(argumentCount, arguments.data()))
+		return 1;
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
\ No newline at end of file
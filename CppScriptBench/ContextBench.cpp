@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+
+#include <CppScript/Context.h>
+#include <CppScript/Incremental.h>
+#include <CppScript/Serializer.h>
+#include <string>
+#include <vector>
+
+using namespace CppScript;
+
+static std::vector<std::string> makeNames(std::size_t count)
+{
+	std::vector<std::string> names;
+	for (std::size_t i = 0; i < count; ++i)
+		names.push_back("variable" + std::to_string(i));
+	return names;
+}
+
+static void ContextGetByName(benchmark::State& state)
+{
+	auto names = makeNames(std::size_t(state.range(0)));
+	Context context;
+	for (const auto& name : names)
+		context.set(name, IntValue(1));
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(&context.get(names[i]));
+		i = (i + 1) % names.size();
+	}
+}
+BENCHMARK(ContextGetByName)->RangeMultiplier(8)->Range(8, 4096);
+
+static void ContextSetByName(benchmark::State& state)
+{
+	auto names = makeNames(std::size_t(state.range(0)));
+	Context context;
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(&context.set(names[i], IntValue(i)));
+		i = (i + 1) % names.size();
+	}
+}
+BENCHMARK(ContextSetByName)->RangeMultiplier(8)->Range(8, 4096);
+
+static void ContextGetBySlot(benchmark::State& state)
+{
+	auto names = makeNames(std::size_t(state.range(0)));
+	Context context;
+	std::vector<Context::Slot> slots;
+	for (const auto& name : names)
+	{
+		slots.push_back(context.getSlot(name));
+		context.set(slots.back(), IntValue(1));
+	}
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(&context.get(slots[i]));
+		i = (i + 1) % slots.size();
+	}
+}
+BENCHMARK(ContextGetBySlot)->RangeMultiplier(8)->Range(8, 4096);
+
+static void ContextSetBySlot(benchmark::State& state)
+{
+	auto names = makeNames(std::size_t(state.range(0)));
+	Context context;
+	std::vector<Context::Slot> slots;
+	for (const auto& name : names)
+		slots.push_back(context.getSlot(name));
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(&context.set(slots[i], IntValue(i)));
+		i = (i + 1) % slots.size();
+	}
+}
+BENCHMARK(ContextSetBySlot)->RangeMultiplier(8)->Range(8, 4096);
+
+// state.range(0) statements output_i = input_i + input_(i+1), one input changes per run;
+// state.range(1) is 0 for running all statements, 1 for running them incrementally
+static void ContextIncrementalUpdate(benchmark::State& state)
+{
+	auto count = std::size_t(state.range(0));
+	auto inputs = makeNames(count + 1);
+	Context context;
+	std::vector<Operation::Ref> statements;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		Json script = { { "type", "Assign" }, { "data", { "output" + std::to_string(i), { { "type", "Add" }, { "data", {
+			{ { "type", "Clone" }, { "data", { { "type", "Read" }, { "data", inputs[i] } } } },
+			{ { "type", "Read" }, { "data", inputs[i + 1] } } } } } } } };
+		JsonLoader loader{ script };
+		statements.emplace_back();
+		loader.serialize(statements.back());
+		VariableResolver resolver{ context };
+		resolver.serialize(statements.back());
+	}
+	for (const auto& input : inputs)
+		context.set(input, IntValue(1));
+
+	Executor executor{ context };
+	IncrementalRunner runner{ context };
+	for (const auto& statement : statements)
+		runner.add(*statement);
+	runner.run();
+	bool incremental = state.range(1) != 0;
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		context.set(inputs[i], IntValue(i));
+		if (incremental)
+			runner.run();
+		else
+			for (const auto& statement : statements)
+				executor.execute(*statement);
+		i = (i + 1) % inputs.size();
+	}
+	state.SetLabel(incremental ? "incremental" : "all");
+}
+BENCHMARK(ContextIncrementalUpdate)->ArgsProduct({ { 64, 512 }, { 0, 1 } });
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <CppScript/Serializer.h>
+#include <CppScript/JsonStream.h>
+#include <CppScript/Cache.h>
+#include <sstream>
+
+using namespace CppScript;
+
+// script summing operationCount cloned reads and literals, nested as a left leaning Add chain
+static Json makeScript(std::size_t operationCount)
+{
+	Json script = { { "type", "Clone" }, { "data", { { "type", "Read" }, { "data", "x" } } } };
+	for (std::size_t i = 1; i < operationCount; ++i)
+	{
+		Json add = { { "type", "Add" }, { "data", Json::array() } };
+		add["data"].push_back(std::move(script));
+		add["data"].push_back(i % 2 ? Json{ { "type", "Value" }, { "data", IntValue(i) } } : Json{ { "type", "Read" }, { "data", "x" } });
+		script = std::move(add);
+	}
+	return script;
+}
+
+static void JsonLoaderLoad(benchmark::State& state)
+{
+	auto script = makeScript(std::size_t(state.range(0)));
+	auto text = script.dump();
+	for (auto _ : state)
+	{
+		auto data = Json::parse(text);
+		JsonLoader loader{ data };
+		Operation::Ref operation;
+		loader.serialize(operation);
+		benchmark::DoNotOptimize(operation);
+	}
+	state.SetBytesProcessed(std::int64_t(state.iterations() * text.size()));
+}
+BENCHMARK(JsonLoaderLoad)->Range(16, 4096);
+
+static void JsonStreamLoaderLoad(benchmark::State& state)
+{
+	auto text = makeScript(std::size_t(state.range(0))).dump();
+	for (auto _ : state)
+	{
+		std::istringstream stream{ text };
+		JsonStreamLoader loader{ stream };
+		Operation::Ref operation;
+		loader.serialize(operation);
+		benchmark::DoNotOptimize(operation);
+	}
+	state.SetBytesProcessed(std::int64_t(state.iterations() * text.size()));
+}
+BENCHMARK(JsonStreamLoaderLoad)->Range(16, 4096);
+
+static void ProgramCacheHit(benchmark::State& state)
+{
+	auto script = makeScript(std::size_t(state.range(0)));
+	ProgramCache cache{ std::size_t(1) << 30 };
+	cache.get(script);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(cache.get(script));
+	state.SetBytesProcessed(std::int64_t(state.iterations() * script.dump().size()));
+}
+BENCHMARK(ProgramCacheHit)->Range(16, 4096);
\ No newline at end of file
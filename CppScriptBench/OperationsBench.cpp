@@ -0,0 +1,162 @@
+#include <benchmark/benchmark.h>
+
+#include <CppScript/Serializer.h>
+#include <CppScript/Execution.h>
+#include <CppScript/Optimizer.h>
+#include <CppScript/NumericArray.h>
+
+using namespace CppScript;
+
+// smallest script exercising each operation type, operands are literals or a read of "x"
+static Json getScript(OperationType opType)
+{
+	switch (opType)
+	{
+	case OperationType::Value:
+		return R"( { "type" : "Value", "data" : 17 } )"_json;
+	case OperationType::Read:
+		return R"( { "type" : "Read", "data" : "x" } )"_json;
+	case OperationType::Clone:
+		return R"( { "type" : "Clone", "data" : { "type" : "Read", "data" : "x" } } )"_json;
+	case OperationType::Assign:
+		return R"( { "type" : "Assign", "data" : [ "y", { "type" : "Read", "data" : "x" } ] } )"_json;
+	case OperationType::Add:
+		return R"( { "type" : "Add", "data" : [ { "type" : "Clone", "data" : { "type" : "Read", "data" : "x" } },
+			{ "type" : "Value", "data" : 3 } ] } )"_json;
+	case OperationType::Range:
+		return R"( { "type" : "Range", "data" : [ { "type" : "Value", "data" : 0 }, { "type" : "Value", "data" : 64 },
+			{ "type" : "Value", "data" : 1 } ] } )"_json;
+	case OperationType::ForLoop:
+		return R"( { "type" : "ForLoop", "data" : [ "i", { "type" : "Range", "data" : [ { "type" : "Value", "data" : 0 },
+			{ "type" : "Value", "data" : 64 }, { "type" : "Value", "data" : 1 } ] }, { "type" : "Read", "data" : "i" } ] } )"_json;
+	default:
+		return {};
+	}
+}
+
+static Operation::Ref loadScript(const Json& script, Context& context)
+{
+	JsonLoader loader{ script };
+	Operation::Ref operation;
+	loader.serialize(operation);
+	VariableResolver resolver{ context };
+	resolver.serialize(operation);
+	context.set("x", IntValue(5));
+	return operation;
+}
+
+static void OperationExecute(benchmark::State& state)
+{
+	auto opType = OperationType(state.range(0));
+	state.SetLabel(Operation::getName(opType));
+	Context context;
+	auto operation = loadScript(getScript(opType), context);
+	Executor executor{ context };
+	for (auto _ : state)
+		benchmark::DoNotOptimize(&executor.execute(*operation));
+}
+BENCHMARK(OperationExecute)->DenseRange(0, int(OperationType::Last) - 1);
+
+static void OperationExecuteCompiled(benchmark::State& state)
+{
+	auto opType = OperationType(state.range(0));
+	state.SetLabel(Operation::getName(opType));
+	Context context;
+	auto operation = loadScript(getScript(opType), context);
+	Program program{ *operation };
+	Executor executor{ context };
+	for (auto _ : state)
+		benchmark::DoNotOptimize(&executor.execute(program));
+}
+BENCHMARK(OperationExecuteCompiled)->DenseRange(0, int(OperationType::Last) - 1);
+
+// the Add script of OperationExecute, generic (0) or specialized by type inference with "x" declared an int (1)
+static void OperationAddInferred(benchmark::State& state)
+{
+	auto inferred = state.range(0) != 0;
+	state.SetLabel(inferred ? "AddIntInt" : "Add");
+	Context context;
+	auto operation = loadScript(getScript(OperationType::Add), context);
+	if (inferred)
+	{
+		TypeInference inference;
+		inference.declare("x", TypeInt::id());
+		inference.serialize(operation);
+	}
+	Executor executor{ context };
+	for (auto _ : state)
+		benchmark::DoNotOptimize(&executor.execute(*operation));
+}
+BENCHMARK(OperationAddInferred)->DenseRange(0, 1);
+
+
+// the shapes OperationFuser fuses, run as they are (0) or fused (1)
+static void OperationFused(benchmark::State& state)
+{
+	static const char* const scripts[] = {
+		R"( { "type" : "Assign", "data" : [ "x", { "type" : "Add", "data" : [ { "type" : "Read", "data" : "x" }, { "type" : "Value", "data" : 0 } ] } ] } )",
+		R"( { "type" : "Add", "data" : [ { "type" : "Read", "data" : "x" }, { "type" : "Read", "data" : "zero" } ] } )",
+		R"( { "type" : "Assign", "data" : [ "y", { "type" : "Clone", "data" : { "type" : "Read", "data" : "x" } } ] } )" };
+	static const char* const labels[] = { "increment", "variable addition", "clone assignment" };
+	auto fused = state.range(1) != 0;
+	state.SetLabel(std::string{ labels[state.range(0)] } + (fused ? " fused" : ""));
+	Context context;
+	context.set("zero", IntValue(0));
+	auto operation = loadScript(Json::parse(scripts[state.range(0)]), context);
+	if (fused)
+	{
+		OperationFuser fuser;
+		fuser.serialize(operation);
+	}
+	Executor executor{ context };
+	for (auto _ : state)
+		benchmark::DoNotOptimize(&executor.execute(*operation));
+}
+BENCHMARK(OperationFused)->ArgsProduct({ { 0, 1, 2 }, { 0, 1 } });
+
+
+// sum of two 1024 element arrays with defensive clones, as written (0) or with the clones elided (1)
+static void OperationClonesElided(benchmark::State& state)
+{
+	auto elided = state.range(0) != 0;
+	state.SetLabel(elided ? "elided" : "cloned");
+	Context context;
+	auto operation = loadScript(R"( { "type" : "Assign", "data" : [ "sum", { "type" : "Clone", "data" : { "type" : "Add", "data" : [
+		{ "type" : "Clone", "data" : { "type" : "Read", "data" : "a" } }, { "type" : "Clone", "data" : { "type" : "Read", "data" : "b" } } ] } } ] } )"_json, context);
+	context.set("a", TypeArray::create(NumericArray::ElementKind::Float, 1024));
+	context.set("b", TypeArray::create(NumericArray::ElementKind::Float, 1024));
+	if (elided)
+	{
+		CloneElider elider;
+		elider.serialize(operation);
+	}
+	Executor executor{ context };
+	for (auto _ : state)
+		benchmark::DoNotOptimize(&executor.execute(*operation));
+}
+BENCHMARK(OperationClonesElided)->DenseRange(0, 1);
+
+
+// adding a bool to a clone of "x" fails on every run, thrown (0) or returned (1)
+static void OperationError(benchmark::State& state)
+{
+	auto returned = state.range(0) != 0;
+	state.SetLabel(returned ? "tryExecute" : "execute");
+	Context context;
+	auto operation = loadScript(R"( { "type" : "Add", "data" : [ { "type" : "Clone", "data" : { "type" : "Read", "data" : "x" } },
+		{ "type" : "Value", "data" : true } ] } )"_json, context);
+	Executor executor{ context };
+	for (auto _ : state)
+		if (returned)
+			benchmark::DoNotOptimize(executor.tryExecute(*operation).getError().getCode());
+		else
+			try
+			{
+				executor.execute(*operation);
+			}
+			catch (const InvalidTypeCast& error)
+			{
+				benchmark::DoNotOptimize(&error);
+			}
+}
+BENCHMARK(OperationError)->DenseRange(0, 1);
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+
+#include <CppScript/BasicTypes.h>
+#include <CppScript/NumericArray.h>
+#include <CppScript/Value.h>
+
+using namespace CppScript;
+
+static void ValueCloneInt(benchmark::State& state)
+{
+	Value value{ IntValue(42) };
+	for (auto _ : state)
+		benchmark::DoNotOptimize(value.clone());
+}
+BENCHMARK(ValueCloneInt);
+
+static void ValueCloneArray(benchmark::State& state)
+{
+	Value value{ TypeArray::create(NumericArray::ElementKind::Float, std::size_t(state.range(0))) };
+	for (auto _ : state)
+		benchmark::DoNotOptimize(value.clone());
+}
+BENCHMARK(ValueCloneArray)->Range(8, 4096);
+
+static void TypeBaseClone(benchmark::State& state)
+{
+	TypeBase::Ref value = TypeInt::create(42);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(value->clone());
+}
+BENCHMARK(TypeBaseClone);
+
+static void TypeOperationsAddInt(benchmark::State& state)
+{
+	TypeBase::Ref destination = TypeInt::create(0);
+	TypeBase::Ref source = TypeInt::create(3);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(*destination += *source);
+}
+BENCHMARK(TypeOperationsAddInt);
+
+static void TypeOperationsAddFloatInt(benchmark::State& state)
+{
+	TypeBase::Ref destination = TypeFloat::create(0.5);
+	TypeBase::Ref source = TypeInt::create(3);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(*destination += *source);
+}
+BENCHMARK(TypeOperationsAddFloatInt);
+
+static void TypeOperationsLess(benchmark::State& state)
+{
+	TypeBase::Ref left = TypeFloat::create(0.5);
+	TypeBase::Ref right = TypeInt::create(3);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(*left < *right);
+}
+BENCHMARK(TypeOperationsLess);
+
+static void ValueAddInt(benchmark::State& state)
+{
+	Value destination{ IntValue(0) };
+	Value source{ IntValue(3) };
+	for (auto _ : state)
+		benchmark::DoNotOptimize(&(destination += source));
+}
+BENCHMARK(ValueAddInt);
+
+static void ValueAddFloatInt(benchmark::State& state)
+{
+	Value destination{ FloatValue(0.5) };
+	Value source{ IntValue(3) };
+	for (auto _ : state)
+		benchmark::DoNotOptimize(&(destination += source));
+}
+BENCHMARK(ValueAddFloatInt);
+
+static void ValueAddArrays(benchmark::State& state)
+{
+	auto size = std::size_t(state.range(0));
+	Value destination{ TypeArray::create(NumericArray::ElementKind::Float, size) };
+	Value source{ TypeArray::create(NumericArray::ElementKind::Float, size) };
+	for (auto _ : state)
+		benchmark::DoNotOptimize(&(destination += source));
+	state.SetItemsProcessed(std::int64_t(state.iterations() * size));
+}
+BENCHMARK(ValueAddArrays)->Range(8, 4096);
\ No newline at end of file
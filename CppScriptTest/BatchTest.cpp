@@ -0,0 +1,81 @@
+#include<gtest/gtest.h>
+
+#include <CppScript/Batch.h>
+#include <CppScript/Serializer.h>
+
+using namespace CppScript;
+
+class BatchFixture : public testing::Test
+{
+protected:
+	Operation::Ref loadOperation(const Json& opData)
+	{
+		JsonLoader data{ opData };
+		Operation::Ref operation;
+		data.serialize(operation);
+		return operation;
+	}
+
+	const Json script = R"( { "type" : "Assign", "data" : [ "result", { "type" : "Add", "data" : [
+		{ "type" : "Clone", "data" : { "type" : "Read", "data" : "input" } },
+		{ "type" : "Add", "data" : [ { "type" : "Clone", "data" : { "type" : "Value", "data" : 2.5 } },
+			{ "type" : "Read", "data" : "offset" } ] } ] } ] } )"_json;
+};
+
+TEST_F(BatchFixture, MatchesRowByRow)
+{
+	auto operation = loadOperation(script);
+	Program program{ *operation };
+
+	constexpr std::size_t rows = 37;
+	ColumnTable columns;
+	NumericArray input{ NumericArray::ElementKind::Float, rows };
+	NumericArray offset{ NumericArray::ElementKind::Int, rows };
+	for (std::size_t row = 0; row < rows; ++row)
+	{
+		input.getFloats()[row] = 0.25 * FloatValue(row);
+		offset.getInts()[row] = IntValue(row % 5) - 2;
+	}
+	columns.set("input", input);
+	columns.set("offset", offset);
+
+	BatchExecutor batch{ columns };
+	auto result = batch.execute(program);
+	ASSERT_EQ(result.size(), rows);
+	EXPECT_TRUE(result == columns.get("result"));
+
+	for (std::size_t row = 0; row < rows; ++row)
+	{
+		Context context;
+		Executor executor{ context };
+		context.set("input", input.getFloats()[row]);
+		context.set("offset", offset.getInts()[row]);
+		EXPECT_EQ(executor.execute(*operation).as<FloatValue>(), result.getFloats()[row]);
+		EXPECT_EQ(context.get("input").as<FloatValue>(), columns.get("input").getFloats()[row]);
+	}
+}
+
+TEST_F(BatchFixture, ScalarsAndLiterals)
+{
+	ColumnTable columns{ 4 };
+	columns.set("counter", NumericArray{ 1ll, 2ll, 3ll, 4ll });
+	BatchExecutor batch{ columns };
+
+	auto constant = loadOperation(R"( { "type" : "Add", "data" : [ { "type" : "Clone", "data" : { "type" : "Value", "data" : 5 } },
+		{ "type" : "Value", "data" : 1 } ] } )"_json);
+	EXPECT_TRUE(batch.execute(Program{ *constant }) == NumericArray({ 6ll, 6ll, 6ll, 6ll }));
+
+	auto increment = loadOperation(R"( { "type" : "Add", "data" : [ { "type" : "Read", "data" : "counter" },
+		{ "type" : "Value", "data" : 10 } ] } )"_json);
+	batch.execute(Program{ *increment });
+	EXPECT_TRUE(columns.get("counter") == NumericArray({ 11ll, 12ll, 13ll, 14ll }));
+
+	auto intoLiteral = loadOperation(R"( { "type" : "Add", "data" : [ { "type" : "Value", "data" : 5 },
+		{ "type" : "Read", "data" : "counter" } ] } )"_json);
+	Program intoLiteralProgram{ *intoLiteral };
+	EXPECT_TRUE(batch.execute(intoLiteralProgram) == NumericArray({ 16ll, 17ll, 18ll, 19ll }));
+	EXPECT_TRUE(batch.execute(intoLiteralProgram) == NumericArray({ 16ll, 17ll, 18ll, 19ll }));
+	auto missing = loadOperation(R"( { "type" : "Read", "data" : "missing" } )"_json);
+	EXPECT_THROW(batch.execute(Program{ *missing }), std::out_of_range);
+	EXPECT_THROW(columns.set("short", NumericArray{ 1ll }), std::invalid_argument);
+}
\ No newline at end of file
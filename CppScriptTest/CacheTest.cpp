@@ -0,0 +1,102 @@
+#include<gtest/gtest.h>
+
+#include <CppScript/Cache.h>
+#include <CppScript/Execution.h>
+#include <filesystem>
+#include <thread>
+
+using namespace CppScript;
+
+class CacheFixture : public testing::Test
+{
+protected:
+	static std::string makeScript(int increment)
+	{
+		return R"( { "type" : "Add", "data" : [ { "type" : "Clone", "data" : { "type" : "Read", "data" : "x" } },
+			{ "type" : "Value", "data" : )" + std::to_string(increment) + " } ] }";
+	}
+
+	IntValue run(const ProgramCache::Tree& tree)
+	{
+		Context context;
+		context.set("x", IntValue(100));
+		Executor executor{ context };
+		return executor.execute(*tree).as<IntValue>();
+	}
+};
+
+TEST_F(CacheFixture, SharesNormalizedScripts)
+{
+	ProgramCache cache{ 1 << 20 };
+	auto first = cache.get(makeScript(5));
+	auto reordered = cache.get(std::string{ R"({"data":[{"data":{"data":"x","type":"Read"},"type":"Clone"},{"data":5,"type":"Value"}],"type":"Add"})" });
+	auto other = cache.get(makeScript(6));
+
+	EXPECT_EQ(first, reordered);
+	EXPECT_NE(first, other);
+	EXPECT_EQ(run(first), 105);
+	EXPECT_EQ(run(other), 106);
+	auto statistics = cache.getStatistics();
+	EXPECT_EQ(statistics.hits, 1);
+	EXPECT_EQ(statistics.misses, 2);
+	EXPECT_EQ(statistics.evictions, 0);
+}
+
+TEST_F(CacheFixture, EvictsLeastRecentlyUsed)
+{
+	ProgramCache probe{ 1 << 20 };
+	probe.get(makeScript(10));
+	auto entryCost = probe.getMemoryUsage();
+	// without a disk tier no binary image is built, the tree is charged its JSON size twice
+	EXPECT_EQ(entryCost, 2 * Json::parse(makeScript(10)).dump().size());
+
+	ProgramCache cache{ entryCost * 2 };
+	auto ten = cache.get(makeScript(10));
+	cache.get(makeScript(11));
+	EXPECT_EQ(cache.get(makeScript(10)), ten);
+	cache.get(makeScript(12));
+	EXPECT_EQ(cache.getStatistics().evictions, 1);
+	EXPECT_LE(cache.getMemoryUsage(), entryCost * 2);
+
+	EXPECT_EQ(cache.get(makeScript(10)), ten);
+	cache.get(makeScript(11));
+	EXPECT_EQ(cache.getStatistics().misses, 4);
+	EXPECT_EQ(run(ten), 110);
+}
+
+TEST_F(CacheFixture, DiskTierSurvivesRestart)
+{
+	auto directory = std::filesystem::temp_directory_path() / "CppScriptCacheTest";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+	{
+		ProgramCache cache{ 1 << 20, directory.string() };
+		EXPECT_EQ(run(cache.get(makeScript(7))), 107);
+		EXPECT_EQ(cache.getStatistics().diskHits, 0);
+	}
+	ProgramCache restarted{ 1 << 20, directory.string() };
+	EXPECT_EQ(run(restarted.get(makeScript(7))), 107);
+	EXPECT_EQ(run(restarted.get(makeScript(8))), 108);
+	EXPECT_EQ(restarted.getStatistics().diskHits, 1);
+	EXPECT_EQ(restarted.getStatistics().misses, 2);
+	std::filesystem::remove_all(directory);
+}
+
+TEST_F(CacheFixture, ConcurrentLookups)
+{
+	ProgramCache cache{ 1 << 20 };
+	std::vector<std::thread> threads;
+	std::vector<IntValue> results(8);
+	for (std::size_t i = 0; i < results.size(); ++i)
+		threads.emplace_back([&, i]()
+			{
+				for (int j = 0; j < 100; ++j)
+					results[i] += run(cache.get(makeScript(j % 4)));
+			});
+	for (auto& thread : threads)
+		thread.join();
+	for (auto result : results)
+		EXPECT_EQ(result, 100 * 100 + 25 * 6);
+	auto statistics = cache.getStatistics();
+	EXPECT_EQ(statistics.hits + statistics.misses, 800);
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include<gtest/gtest.h>
+
+#include <CppScript/Incremental.h>
+#include <CppScript/Jit.h>
+#include <CppScript/Serializer.h>
+
+using namespace CppScript;
+
+class IncrementalFixture : public testing::Test
+{
+protected:
+	Operation::Ref loadOperation(const Json& opData)
+	{
+		JsonLoader data{ opData };
+		Operation::Ref operation;
+		data.serialize(operation);
+		VariableResolver resolver{ context };
+		resolver.serialize(operation);
+		return operation;
+	}
+
+	void addStatement(const Json& opData)
+	{
+		auto operation = loadOperation(opData);
+		runner.add(*operation);
+		operations.push_back(std::move(operation));
+	}
+
+	// target = first + second
+	void addSum(const std::string& target, const std::string& first, const std::string& second)
+	{
+		addStatement({ { "type", "Assign" }, { "data", { target, { { "type", "Add" }, { "data", {
+			{ { "type", "Clone" }, { "data", { { "type", "Read" }, { "data", first } } } },
+			{ { "type", "Read" }, { "data", second } } } } } } } });
+	}
+
+	void expectRuns(std::size_t executed, std::size_t skipped)
+	{
+		EXPECT_EQ(runner.getStatistics().executed, executed);
+		EXPECT_EQ(runner.getStatistics().skipped, skipped);
+	}
+
+	Context context;
+	IncrementalRunner runner{ context };
+	std::vector<Operation::Ref> operations;
+};
+
+TEST_F(IncrementalFixture, RecomputesAffectedStatements)
+{
+	context.set("a", 1);
+	context.set("b", 2);
+	context.set("c", 10);
+	addSum("x", "a", "b");
+	addSum("y", "c", "c");
+	addSum("z", "x", "y");
+
+	runner.run();
+	expectRuns(3, 0);
+	EXPECT_EQ(context.get("z").as<IntValue>(), 23);
+	runner.run();
+	expectRuns(3, 3);
+
+	context.set("a", 5);
+	runner.run();
+	expectRuns(5, 4);
+	EXPECT_EQ(context.get("z").as<IntValue>(), 27);
+
+	// outputs changed from outside are computed again
+	context.set("y", 0);
+	runner.run();
+	expectRuns(7, 5);
+	EXPECT_EQ(context.get("y").as<IntValue>(), 20);
+	EXPECT_EQ(context.get("z").as<IntValue>(), 27);
+
+	runner.invalidate();
+	runner.run();
+	expectRuns(10, 5);
+}
+
+TEST_F(IncrementalFixture, StatementsChangingTheirInputsAlwaysRun)
+{
+	context.set("total", 0);
+	context.set("step", 2);
+	addStatement(R"( { "type" : "Add", "data" : [ { "type" : "Read", "data" : "total" }, { "type" : "Read", "data" : "step" } ] } )"_json);
+	addSum("doubled", "total", "total");
+	addSum("sum", "step", "missing");
+
+	EXPECT_EQ(runner.tryRun().getCode(), ErrorCode::UnsetVariable);
+	expectRuns(3, 0);
+	context.set("missing", 1);
+	runner.run();
+	expectRuns(6, 0);
+	EXPECT_EQ(context.get("total").as<IntValue>(), 4);
+	EXPECT_EQ(context.get("doubled").as<IntValue>(), 8);
+
+	runner.run();
+	expectRuns(8, 1);
+	EXPECT_EQ(context.get("total").as<IntValue>(), 6);
+	EXPECT_EQ(context.get("doubled").as<IntValue>(), 12);
+	EXPECT_EQ(context.get("sum").as<IntValue>(), 3);
+}
+
+TEST_F(IncrementalFixture, NativeAssignmentsAreSeen)
+{
+	context.set("x", 1);
+	addStatement(R"( { "type" : "Assign", "data" : [ "y", { "type" : "Read", "data" : "x" } ] } )"_json);
+	runner.run();
+	EXPECT_EQ(context.get("y").as<IntValue>(), 1);
+
+	auto assignment = loadOperation(R"( { "type" : "Assign", "data" : [ "x", { "type" : "Value", "data" : 5 } ] } )"_json);
+	Program program{ *assignment };
+	Executor executor{ context };
+	executor.setJitEnabled(true);
+	executor.execute(program);
+	EXPECT_EQ(executor.getJitStatistics().nativeRuns, NativeCode::isSupported() ? 1 : 0);
+	runner.run();
+	expectRuns(2, 0);
+	EXPECT_EQ(context.get("y").as<IntValue>(), 5);
+}
\ No newline at end of file
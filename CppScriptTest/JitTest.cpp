@@ -0,0 +1,155 @@
+#include<gtest/gtest.h>
+
+#include <CppScript/Jit.h>
+#include <CppScript/Execution.h>
+#include <CppScript/Serializer.h>
+#include <random>
+
+using namespace CppScript;
+
+class JitFixture : public testing::Test
+{
+protected:
+	Operation::Ref loadOperation(const Json& opData, Context& cntx)
+	{
+		JsonLoader data{ opData };
+		Operation::Ref operation;
+		data.serialize(operation);
+		VariableResolver resolver{ cntx };
+		resolver.serialize(operation);
+		return operation;
+	}
+
+	Json randomExpression(int depth)
+	{
+		const char* names[] = { "a", "b", "c" };
+		auto name = names[random() % 3];
+		auto choice = depth > 0 ? random() % 6 : random() % 3;
+		switch (choice)
+		{
+		case 0:
+			return { { "type", "Value" }, { "data", int(random() % 200) - 100 } };
+		case 1:
+			return { { "type", "Read" }, { "data", name } };
+		case 2:
+			return { { "type", "Clone" }, { "data", { { "type", "Read" }, { "data", name } } } };
+		case 3:
+			return { { "type", "Clone" }, { "data", randomExpression(depth - 1) } };
+		case 4:
+			return { { "type", "Assign" }, { "data", { name, randomExpression(depth - 1) } } };
+		default:
+			return { { "type", "Add" }, { "data", { randomExpression(depth - 1), randomExpression(depth - 1) } } };
+		}
+	}
+
+	void setVariables(Context& cntx, const Value& a, const Value& b)
+	{
+		cntx.set("a", a);
+		cntx.set("b", b);
+		cntx.getSlot("c");
+	}
+
+	// runs the tree interpreter and the JIT side by side, several times as literals and variables change,
+	// returns how many of the runs were native
+	std::size_t expectSameResults(const Json& opData, const Value& a, const Value& b)
+	{
+		Context treeContext, jitContext;
+		auto treeOperation = loadOperation(opData, treeContext);
+		auto jitOperation = loadOperation(opData, jitContext);
+		setVariables(treeContext, a, b);
+		setVariables(jitContext, a, b);
+		Executor treeExecutor{ treeContext };
+		Executor jitExecutor{ jitContext };
+		jitExecutor.setJitEnabled(true);
+		Program program{ *jitOperation };
+
+		for (int run = 0; run < 3; ++run)
+		{
+			Value treeResult, jitResult;
+			bool treeThrows = false, jitThrows = false;
+			try
+			{
+				treeResult = treeExecutor.execute(*treeOperation);
+			}
+			catch (const std::exception&)
+			{
+				treeThrows = true;
+			}
+			try
+			{
+				jitResult = jitExecutor.execute(program);
+			}
+			catch (const std::exception&)
+			{
+				jitThrows = true;
+			}
+			EXPECT_EQ(jitThrows, treeThrows) << opData.dump();
+			if (!treeThrows)
+			{
+				EXPECT_TRUE(jitResult == treeResult) << opData.dump();
+			}
+			for (const char* name : { "a", "b", "c" })
+			{
+				const auto& treeValue = *treeContext.getStorage(treeContext.getSlot(name));
+				const auto& jitValue = *jitContext.getStorage(jitContext.getSlot(name));
+				EXPECT_EQ(jitValue.getKind(), treeValue.getKind()) << opData.dump();
+				if (!treeValue.isNone())
+				{
+					EXPECT_TRUE(jitValue == treeValue) << opData.dump();
+				}
+			}
+		}
+		return jitExecutor.getJitStatistics().nativeRuns;
+	}
+
+	std::mt19937 random{ 20240611 };
+};
+
+TEST_F(JitFixture, RandomProgramsMatchTree)
+{
+	std::size_t nativeRuns = 0;
+	for (int i = 0; i < 300; ++i)
+		nativeRuns += expectSameResults(randomExpression(4), IntValue(random() % 1000), IntValue(random() % 1000) - 500);
+	EXPECT_EQ(nativeRuns > 0, NativeCode::isSupported());
+}
+
+TEST_F(JitFixture, GuardFailureFallsBack)
+{
+	for (int i = 0; i < 100; ++i)
+		expectSameResults(randomExpression(3), FloatValue(2.5), IntValue(7));
+}
+
+TEST_F(JitFixture, RunsNative)
+{
+	Context context;
+	auto operation = loadOperation(R"( { "type" : "Assign", "data" : [ "c", { "type" : "Add", "data" :
+		[ { "type" : "Clone", "data" : { "type" : "Read", "data" : "a" } }, { "type" : "Value", "data" : 40 } ] } ] } )"_json, context);
+	Program program{ *operation };
+	Executor executor{ context };
+	executor.setJitEnabled(true);
+
+	context.set("a", IntValue(2));
+	EXPECT_EQ(executor.execute(program).as<IntValue>(), 42);
+	EXPECT_EQ(context.get("c").as<IntValue>(), 42);
+	context.set("a", FloatValue(0.5));
+	EXPECT_EQ(executor.execute(program).as<FloatValue>(), 40.5);
+
+	auto expectedNative = NativeCode::isSupported() ? 1u : 0u;
+	EXPECT_EQ(executor.getJitStatistics().nativeRuns, expectedNative);
+	EXPECT_EQ(executor.getJitStatistics().guardFailures, expectedNative);
+	EXPECT_EQ(program.getNativeCode() != nullptr, NativeCode::isSupported());
+}
+
+TEST_F(JitFixture, UnsupportedProgramIsInterpreted)
+{
+	Context context;
+	auto operation = loadOperation(R"( { "type" : "Add", "data" :
+		[ { "type" : "Clone", "data" : { "type" : "Value", "data" : 1.5 } }, { "type" : "Value", "data" : 2 } ] } )"_json, context);
+	Program program{ *operation };
+	Executor executor{ context };
+	executor.setJitEnabled(true);
+
+	EXPECT_EQ(executor.execute(program).as<FloatValue>(), 3.5);
+	EXPECT_EQ(program.getNativeCode(), nullptr);
+	EXPECT_EQ(executor.getJitStatistics().nativeRuns, 0u);
+}
\ No newline at end of file
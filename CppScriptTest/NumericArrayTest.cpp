@@ -0,0 +1,125 @@
+#include<gtest/gtest.h>
+
+#include <CppScript/NumericArray.h>
+#include <CppScript/ArrayKernels.h>
+#include <CppScript/Serializer.h>
+#include <CppScript/JsonStream.h>
+#include <CppScript/Binary.h>
+#include <CppScript/Execution.h>
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+using namespace CppScript;
+
+
+TEST(NumericArrayTest, KernelsMatchScalar)
+{
+	const auto& kernels = ArrayKernels::get();
+	const auto& scalar = ArrayKernels::getScalar();
+	for (std::size_t size : { 0, 1, 3, 8, 17 })
+	{
+		std::vector<FloatValue> floats(size), otherFloats(size);
+		std::vector<IntValue> ints(size), otherInts(size);
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			floats[i] = FloatValue(i) * 0.5;
+			otherFloats[i] = FloatValue(size - i);
+			ints[i] = IntValue(i * i);
+			otherInts[i] = -IntValue(i);
+		}
+		auto expectedFloats = floats;
+		auto expectedInts = ints;
+		scalar.addFloats(expectedFloats.data(), otherFloats.data(), size);
+		scalar.addFloatScalar(expectedFloats.data(), 1.5, size);
+		scalar.addInts(expectedInts.data(), otherInts.data(), size);
+		scalar.addIntScalar(expectedInts.data(), 7, size);
+		kernels.addFloats(floats.data(), otherFloats.data(), size);
+		kernels.addFloatScalar(floats.data(), 1.5, size);
+		kernels.addInts(ints.data(), otherInts.data(), size);
+		kernels.addIntScalar(ints.data(), 7, size);
+
+		EXPECT_EQ(floats, expectedFloats) << kernels.name;
+		EXPECT_EQ(ints, expectedInts) << kernels.name;
+		EXPECT_EQ(kernels.sumFloats(floats.data(), size), scalar.sumFloats(floats.data(), size)) << kernels.name;
+		EXPECT_EQ(kernels.sumInts(ints.data(), size), std::accumulate(ints.begin(), ints.end(), IntValue(0))) << kernels.name;
+		EXPECT_TRUE(kernels.equalFloats(floats.data(), expectedFloats.data(), size));
+		if (size > 0)
+		{
+			floats.back() += 1;
+			EXPECT_FALSE(kernels.equalFloats(floats.data(), expectedFloats.data(), size));
+		}
+	}
+}
+
+TEST(NumericArrayTest, ValueOperators)
+{
+	Value ints{ TypeArray::create(NumericArray{ 1ll, 2ll, 3ll, 4ll, 5ll }) };
+	Value floats{ TypeArray::create(NumericArray{ 0.5, 1.5, 2.5, 3.5, 4.5 }) };
+	EXPECT_EQ(ints.getKind(), Value::Kind::Object);
+	EXPECT_EQ(ints.getId(), TypeArray::id());
+
+	ints += 10;
+	EXPECT_EQ(ints.as<NumericArray>().sum().as<IntValue>(), 65);
+	floats += ints;
+	EXPECT_EQ(floats.as<NumericArray>().sum().as<FloatValue>(), 77.5);
+	EXPECT_EQ(floats.as<NumericArray>().min().as<FloatValue>(), 11.5);
+	EXPECT_EQ(floats.as<NumericArray>().max().as<FloatValue>(), 19.5);
+	EXPECT_THROW(ints += floats, InvalidTypeCast);
+	EXPECT_THROW(ints += 0.5, InvalidTypeCast);
+	EXPECT_THROW(ints += Value{ TypeArray::create(NumericArray{ 1ll }) }, InvalidOperation);
+
+	auto cloned = ints.clone();
+	EXPECT_TRUE(cloned == ints);
+	cloned += 1;
+	EXPECT_FALSE(cloned == ints);
+	EXPECT_TRUE(ints < cloned);
+	EXPECT_TRUE(Value{ TypeArray::create(NumericArray{ 1ll, 2ll }) } == Value{ TypeArray::create(NumericArray{ 1.0, 2.0 }) });
+
+	// none, e.g. from a loop that never ran, has no object to add or compare
+	EXPECT_THROW(ints += Value{}, InvalidTypeCast);
+	EXPECT_THROW(static_cast<void>(ints == Value{}), InvalidTypeCast);
+	EXPECT_THROW(static_cast<void>(ints < Value{}), InvalidTypeCast);
+}
+
+TEST(NumericArrayTest, ArrayLiterals)
+{
+	const auto script = R"( { "type" : "Add", "data" : [
+		{ "type" : "Clone", "data" : { "type" : "Value", "data" : [ 1, 2.5, 3 ] } },
+		{ "type" : "Value", "data" : [ 10, 20, 30 ] } ] } )";
+	Context context;
+	Executor executor{ context };
+
+	const auto scriptJson = Json::parse(script);
+	JsonLoader loader{ scriptJson };
+	Operation::Ref operation;
+	loader.serialize(operation);
+	const auto& result = executor.execute(*operation).as<NumericArray>();
+	ASSERT_EQ(result.getElementKind(), NumericArray::ElementKind::Float);
+	EXPECT_EQ(result.getFloats()[1], 22.5);
+
+	std::istringstream stream{ script };
+	JsonStreamLoader streamLoader{ stream };
+	Operation::Ref streamed;
+	streamLoader.serialize(streamed);
+	EXPECT_TRUE(executor.execute(*streamed) == Value{ TypeArray::create(NumericArray{ 11.0, 22.5, 33.0 }) });
+
+	BinaryWriter writer;
+	writer.serialize(operation);
+	auto data = writer.getData();
+	BinaryLoader binaryLoader{ data.data(), data.size() };
+	Operation::Ref loaded;
+	binaryLoader.serialize(loaded);
+	EXPECT_EQ(executor.execute(*loaded).as<NumericArray>().sum().as<FloatValue>(), 66.5);
+
+	const auto invalid = R"( { "type" : "Value", "data" : [ 1, true ] } )"_json;
+	JsonLoader invalidLoader{ invalid };
+	EXPECT_THROW(invalidLoader.serialize(operation), NotBaseType);
+
+	const auto emptyLoop = R"( { "type" : "Add", "data" : [ { "type" : "Value", "data" : [ 1, 2 ] }, { "type" : "ForLoop", "data" : [ "i",
+		{ "type" : "Range", "data" : [ { "type" : "Value", "data" : 0 }, { "type" : "Value", "data" : 0 }, { "type" : "Value", "data" : 1 } ] },
+		{ "type" : "Read", "data" : "i" } ] } ] } )"_json;
+	JsonLoader emptyLoopLoader{ emptyLoop };
+	emptyLoopLoader.serialize(operation);
+	EXPECT_EQ(executor.tryExecute(*operation).getError().getCode(), ErrorCode::InvalidTypeCast);
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <CppScript/Serializer.h>
 #include <CppScript/Execution.h>
 #include <CppScript/BasicTypes.h>
+#include <CppScript/NumericArray.h>
 
 using namespace CppScript;
 
@@ -15,13 +16,15 @@ protected:
 		JsonLoader data{ opData };
 		Operation::Ref operation;
 		data.serialize(operation);
+		VariableResolver resolver{ context };
+		resolver.serialize(operation);
 		return operation;
 	}
 
 	void setTestVariables(double var1, int var2)
 	{
-		executor.getContext().set("varOne", TypeFloat::create(var1));
-		executor.getContext().set("varTwo", TypeInt::create(var2));
+		executor.getContext().set("varOne", var1);
+		executor.getContext().set("varTwo", var2);
 	}
 
 
@@ -32,20 +35,20 @@ TEST_F(OperationsFixture, GetValue)
 {
 	auto valueProvider = loadOperation(R"( { "type" : "Value", "data" : 456 } )"_json);
 	ASSERT_TRUE(bool(valueProvider));
-	auto value = valueProvider->execute(executor);
-	EXPECT_EQ(value->as<TypeInt::ValueType>(), 456);
+	auto& value = executor.execute(*valueProvider);
+	EXPECT_EQ(value.as<TypeInt::ValueType>(), 456);
 }
 
-TEST_F(OperationsFixture, GetValueIsNotClone)
+TEST_F(OperationsFixture, GetValueIsCopy)
 {
 	auto valueProvider = loadOperation(R"( { "type" : "Value", "data" : 789.12 } )"_json);
 	ASSERT_TRUE(bool(valueProvider));
-	auto value = valueProvider->execute(executor);
-	EXPECT_EQ(value->as<TypeFloat::ValueType>(), 789.12);
+	auto& value = executor.execute(*valueProvider);
+	EXPECT_EQ(value.as<TypeFloat::ValueType>(), TypeFloat::ValueType(789.12));
 
-	(*value) += *TypeFloat::create(15.6);
-	auto valueChanged = valueProvider->execute(executor);
-	EXPECT_EQ(valueChanged->as<TypeFloat::ValueType>(), 804.72);
+	value += TypeFloat::create(15.6);
+	auto& valueUnchanged = executor.execute(*valueProvider);
+	EXPECT_EQ(valueUnchanged.as<TypeFloat::ValueType>(), TypeFloat::ValueType(789.12));
 }
 
 TEST_F(OperationsFixture, ReadValue)
@@ -53,35 +56,35 @@ TEST_F(OperationsFixture, ReadValue)
 	auto valueReader = loadOperation(R"( { "type" : "Read", "data" : "varOne" } )"_json);
 	ASSERT_TRUE(bool(valueReader));
 	setTestVariables(9.625, -14);
-	auto value = valueReader->execute(executor);
-	EXPECT_EQ(value->as<TypeFloat::ValueType>(), 9.625);
+	auto& value = executor.execute(*valueReader);
+	EXPECT_EQ(value.as<TypeFloat::ValueType>(), 9.625);
 
-	(*value) += *loadOperation(R"( { "type" : "Read", "data" : "varTwo" } )"_json)->execute(executor);
-	auto valueChanged = valueReader->execute(executor);
-	EXPECT_EQ(valueChanged->as<TypeFloat::ValueType>(), -4.375);
+	value += executor.execute(*loadOperation(R"( { "type" : "Read", "data" : "varTwo" } )"_json));
+	auto& valueChanged = executor.execute(*valueReader);
+	EXPECT_EQ(valueChanged.as<TypeFloat::ValueType>(), -4.375);
 }
 
 TEST_F(OperationsFixture, AssignValue)
 {
 	auto valueAssigner = loadOperation(R"( { "type" : "Assign", "data" : [ "varDest", { "type" : "Value", "data" : -159 } ] } )"_json);
 	ASSERT_TRUE(bool(valueAssigner));
-	auto value = valueAssigner->execute(executor);
-	EXPECT_EQ(value->as<TypeInt::ValueType>(), -159);
+	auto& value = executor.execute(*valueAssigner);
+	EXPECT_EQ(value.as<TypeInt::ValueType>(), -159);
 
-	EXPECT_EQ(executor.getContext().get("varDest")->as<TypeInt::ValueType>(), -159);
+	EXPECT_EQ(executor.getContext().get("varDest").as<TypeInt::ValueType>(), -159);
 }
 
 TEST_F(OperationsFixture, CloneValue)
 {
 	auto valueProvider = loadOperation(R"( { "type" : "Clone", "data" : { "type" : "Value", "data" : 7410 } } )"_json);
 	ASSERT_TRUE(bool(valueProvider));
-	auto value = valueProvider->execute(executor);
-	EXPECT_EQ(value->as<TypeInt::ValueType>(), 7410);
+	auto& value = executor.execute(*valueProvider);
+	EXPECT_EQ(value.as<TypeInt::ValueType>(), 7410);
 
-	(*value) += *TypeInt::create(85);
-	EXPECT_EQ(value->as<TypeInt::ValueType>(), 7495);
-	auto valueNotChanged = valueProvider->execute(executor);
-	EXPECT_EQ(valueNotChanged->as<TypeInt::ValueType>(), 7410);
+	value += 85;
+	EXPECT_EQ(value.as<TypeInt::ValueType>(), 7495);
+	auto& valueNotChanged = executor.execute(*valueProvider);
+	EXPECT_EQ(valueNotChanged.as<TypeInt::ValueType>(), 7410);
 }
 
 TEST_F(OperationsFixture, AddValues)
@@ -90,15 +93,232 @@ TEST_F(OperationsFixture, AddValues)
 		[ { "type" : "Read", "data" : "varTwo" }, { "type" : "Value", "data" : 93 } ] } )"_json);
 	ASSERT_TRUE(bool(valueAdder));
 	setTestVariables(74.1, 85);
-	auto value = valueAdder->execute(executor);
-	EXPECT_EQ(value->as<TypeInt::ValueType>(), 178);
+	auto& value = executor.execute(*valueAdder);
+	EXPECT_EQ(value.as<TypeInt::ValueType>(), 178);
 
 	valueAdder = loadOperation(R"( { "type" : "Add", "data" : 
 		[ { "type" : "Read", "data" : "varOne" }, { "type" : "Read", "data" : "varTwo" } ] } )"_json);
 	ASSERT_TRUE(bool(valueAdder));
-	value = valueAdder->execute(executor);
-	EXPECT_EQ(value->as<TypeFloat::ValueType>(), 252.1);
+	auto& sumValue = executor.execute(*valueAdder);
+	EXPECT_EQ(sumValue.as<TypeFloat::ValueType>(), TypeFloat::ValueType(74.1) + 178);
 
-	EXPECT_EQ(executor.getContext().get("varOne")->as<TypeFloat::ValueType>(), 252.1);
-	EXPECT_EQ(executor.getContext().get("varTwo")->as<TypeInt::ValueType>(), 178);
+	EXPECT_EQ(executor.getContext().get("varOne").as<TypeFloat::ValueType>(), TypeFloat::ValueType(74.1) + 178);
+	EXPECT_EQ(executor.getContext().get("varTwo").as<TypeInt::ValueType>(), 178);
+}
+
+TEST_F(OperationsFixture, ReadValueBySlot)
+{
+	auto valueReader = loadOperation(R"( { "type" : "Read", "data" : "varSlot" } )"_json);
+	ASSERT_TRUE(bool(valueReader));
+	auto slot = context.getSlot("varSlot");
+	EXPECT_EQ(context.getSlot("varSlot"), slot);
+	EXPECT_THROW(executor.execute(*valueReader), std::out_of_range);
+
+	context.set(slot, 31);
+	EXPECT_EQ(executor.execute(*valueReader).as<TypeInt::ValueType>(), 31);
+	context.set(slot, 2.5);
+	EXPECT_EQ(executor.execute(*valueReader).as<TypeFloat::ValueType>(), 2.5);
+	EXPECT_EQ(context.get("varSlot").as<TypeFloat::ValueType>(), 2.5);
+
+	// slots the other context does not have are unset variables there
+	Context other;
+	Executor otherExecutor{ other };
+	EXPECT_EQ(otherExecutor.tryExecute(*valueReader).getError().getCode(), ErrorCode::UnsetVariable);
+	EXPECT_THROW(other.get(slot), std::out_of_range);
+	EXPECT_THROW(other.set(slot, 1), std::out_of_range);
+}
+
+TEST_F(OperationsFixture, AssignValueUnresolved)
+{
+	auto opData = R"( { "type" : "Assign", "data" : [ "varNew", { "type" : "Read", "data" : "varTwo" } ] } )"_json;
+	JsonLoader data{ opData };
+	Operation::Ref valueAssigner;
+	data.serialize(valueAssigner);
+	ASSERT_TRUE(bool(valueAssigner));
+	setTestVariables(1.5, 42);
+	EXPECT_EQ(executor.execute(*valueAssigner).as<TypeInt::ValueType>(), 42);
+	EXPECT_EQ(context.get(context.getSlot("varNew")).as<TypeInt::ValueType>(), 42);
+}
+
+TEST_F(OperationsFixture, BindingNamesKeepsOperands)
+{
+	auto opData = R"( { "type" : "Add", "data" : [ { "type" : "Read", "data" : "a" },
+		{ "type" : "Assign", "data" : [ "fresh", { "type" : "Value", "data" : 1 } ] } ] } )"_json;
+	JsonLoader data{ opData };
+	Operation::Ref adder;
+	data.serialize(adder);
+	context.set("a", 1);
+	// the fresh name starts a new chunk of storage
+	for (int i = 1; i < 64; ++i)
+		context.getSlot("name" + std::to_string(i));
+	EXPECT_EQ(executor.execute(*adder).as<IntValue>(), 2);
+	EXPECT_EQ(context.get("fresh").as<IntValue>(), 1);
+}
+
+TEST_F(OperationsFixture, RangeValues)
+{
+	auto intRange = loadOperation(R"( { "type" : "Range", "data" : [
+		{ "type" : "Value", "data" : 10 }, { "type" : "Value", "data" : 0 }, { "type" : "Value", "data" : -3 } ] } )"_json);
+	EXPECT_TRUE(executor.execute(*intRange).as<NumericArray>() == NumericArray({ 10ll, 7ll, 4ll, 1ll }));
+
+	auto floatRange = loadOperation(R"( { "type" : "Range", "data" : [
+		{ "type" : "Value", "data" : 0 }, { "type" : "Value", "data" : 1 }, { "type" : "Value", "data" : 0.25 } ] } )"_json);
+	EXPECT_TRUE(executor.execute(*floatRange).as<NumericArray>() == NumericArray({ 0.0, 0.25, 0.5, 0.75 }));
+
+	auto zeroStep = loadOperation(R"( { "type" : "Range", "data" : [
+		{ "type" : "Value", "data" : 0 }, { "type" : "Value", "data" : 1 }, { "type" : "Value", "data" : 0 } ] } )"_json);
+	EXPECT_THROW(executor.execute(*zeroStep), InvalidOperation);
+
+	// counts that are infinite or too large for an array are script errors
+	auto makeRange = [this](Json begin, Json end, Json step)
+	{
+		return loadOperation({ { "type", "Range" }, { "data", { { { "type", "Value" }, { "data", begin } },
+			{ { "type", "Value" }, { "data", end } }, { { "type", "Value" }, { "data", step } } } } });
+	};
+	// the distance overflows to infinity when FloatValue is float
+	auto infinite = makeRange(-3e38, 3e38, 1e-38);
+	EXPECT_EQ(executor.tryExecute(*infinite).getError().getCode(), ErrorCode::InvalidOperation);
+	auto hugeFloat = makeRange(0, 1e30, 1);
+	EXPECT_EQ(executor.tryExecute(*hugeFloat).getError().getCode(), ErrorCode::InvalidOperation);
+	auto hugeInt = makeRange(0, 1ll << 40, 1);
+	EXPECT_EQ(executor.tryExecute(*hugeInt).getError().getCode(), ErrorCode::InvalidOperation);
+}
+
+TEST_F(OperationsFixture, ForLoopOverIntRange)
+{
+	auto loop = loadOperation(R"( { "type" : "ForLoop", "data" : [ "i",
+		{ "type" : "Range", "data" : [ { "type" : "Value", "data" : 0 }, { "type" : "Read", "data" : "varTwo" }, { "type" : "Value", "data" : 1 } ] },
+		{ "type" : "Add", "data" : [ { "type" : "Read", "data" : "varOne" }, { "type" : "Read", "data" : "i" } ] } ] } )"_json);
+	setTestVariables(0.5, 10);
+	EXPECT_EQ(executor.execute(*loop).as<FloatValue>(), 45.5);
+	EXPECT_EQ(context.get("i").as<IntValue>(), 9);
+
+	setTestVariables(0.5, 0);
+	EXPECT_TRUE(executor.execute(*loop).isNone());
+	EXPECT_EQ(context.get("varOne").as<FloatValue>(), 0.5);
+}
+
+TEST_F(OperationsFixture, ForLoopReusesTemporaries)
+{
+	auto loop = loadOperation(R"( { "type" : "ForLoop", "data" : [ "x", { "type" : "Value", "data" : [ 0.5, 1.5, 2.5, 3.5 ] },
+		{ "type" : "Assign", "data" : [ "varOne", { "type" : "Add", "data" : [
+			{ "type" : "Clone", "data" : { "type" : "Read", "data" : "varOne" } }, { "type" : "Read", "data" : "x" } ] } ] } ] } )"_json);
+	setTestVariables(1.0, 0);
+	EXPECT_EQ(executor.execute(*loop).as<FloatValue>(), 9.0);
+	EXPECT_EQ(executor.getTemporaryMark(), 2);
+	EXPECT_EQ(executor.execute(*loop).as<FloatValue>(), 17.0);
+
+	Program program{ *loop };
+	EXPECT_EQ(program.code.size(), 1);
+	EXPECT_EQ(executor.execute(program).as<FloatValue>(), 25.0);
+	EXPECT_EQ(context.get("x").as<FloatValue>(), 3.5);
+}
+
+TEST_F(OperationsFixture, ErrorsAreReturned)
+{
+	auto adder = loadOperation(R"( { "type" : "Add", "data" : [ { "type" : "Read", "data" : "varTwo" },
+		{ "type" : "Read", "data" : "varOne" } ] } )"_json);
+	auto unset = executor.tryExecute(*adder);
+	ASSERT_FALSE(unset);
+	EXPECT_EQ(unset.getError().getCode(), ErrorCode::UnsetVariable);
+	EXPECT_EQ(unset.getError().getMessage(), "Context variable is not set: varTwo");
+
+	setTestVariables(0.5, 3);
+	auto mismatch = executor.tryExecute(*adder);
+	ASSERT_FALSE(mismatch);
+	EXPECT_EQ(mismatch.getError().getCode(), ErrorCode::InvalidTypeCast);
+	EXPECT_EQ(executor.tryExecute(Program{ *adder }).getError().getCode(), ErrorCode::InvalidTypeCast);
+	try
+	{
+		executor.execute(*adder);
+		FAIL();
+	}
+	catch (const InvalidTypeCast& error)
+	{
+		EXPECT_STREQ(error.what(), "Cannot cast from: float to: int");
+	}
+
+	context.set("varOne", 5);
+	auto sum = executor.tryExecute(*adder);
+	ASSERT_TRUE(sum);
+	EXPECT_EQ((*sum)->as<IntValue>(), 8);
+}
+
+TEST_F(OperationsFixture, SharedValuesAreCopiedOnWrite)
+{
+	context.set("array", TypeArray::create(NumericArray{ 1ll, 2ll }));
+	auto copy = loadOperation(R"( { "type" : "Assign", "data" : [ "copy", { "type" : "Read", "data" : "array" } ] } )"_json);
+	auto addToCopy = loadOperation(R"( { "type" : "Add", "data" : [ { "type" : "Read", "data" : "copy" }, { "type" : "Value", "data" : 10 } ] } )"_json);
+	auto addToArray = loadOperation(R"( { "type" : "Add", "data" : [ { "type" : "Read", "data" : "array" }, { "type" : "Value", "data" : 1 } ] } )"_json);
+	const auto* arrayObject = context.get("array").getObject().get();
+	executor.execute(*copy);
+	EXPECT_TRUE(context.get("copy").isShared());
+
+	executor.execute(*addToCopy);
+	EXPECT_TRUE(context.get("copy") == Value{ TypeArray::create(NumericArray{ 11ll, 12ll }) });
+	EXPECT_TRUE(context.get("array") == Value{ TypeArray::create(NumericArray{ 1ll, 2ll }) });
+	EXPECT_FALSE(context.get("array").isShared());
+	executor.execute(Program{ *addToArray });
+	EXPECT_TRUE(context.get("array") == Value{ TypeArray::create(NumericArray{ 2ll, 3ll }) });
+	EXPECT_EQ(context.get("array").getObject().get(), arrayObject);
+
+	auto intoLiteral = loadOperation(R"( { "type" : "Add", "data" : [ { "type" : "Value", "data" : [ 1, 2 ] }, { "type" : "Value", "data" : 1 } ] } )"_json);
+	EXPECT_TRUE(executor.execute(*intoLiteral) == Value{ TypeArray::create(NumericArray{ 2ll, 3ll }) });
+	EXPECT_TRUE(executor.execute(*intoLiteral) == Value{ TypeArray::create(NumericArray{ 2ll, 3ll }) });
+	EXPECT_TRUE(executor.execute(Program{ *intoLiteral }) == Value{ TypeArray::create(NumericArray{ 2ll, 3ll }) });
+}
+
+class CompiledOperationsFixture : public OperationsFixture
+{
+protected:
+	void expectSameResults(const Json& opData, double var1, int var2)
+	{
+		auto operation = loadOperation(opData);
+		ASSERT_TRUE(bool(operation));
+		setTestVariables(var1, var2);
+		auto& treeResult = executor.execute(*operation);
+
+		Context compiledContext;
+		Executor compiledExecutor{ compiledContext };
+		VariableResolver resolver{ compiledContext };
+		resolver.serialize(operation);
+		compiledContext.set("varOne", var1);
+		compiledContext.set("varTwo", var2);
+		Program program{ *operation };
+		auto& compiledResult = compiledExecutor.execute(program);
+
+		EXPECT_EQ(compiledResult.getId(), treeResult.getId());
+		EXPECT_TRUE(compiledResult == treeResult);
+		EXPECT_TRUE(compiledContext.get("varOne") == context.get("varOne"));
+		EXPECT_TRUE(compiledContext.get("varTwo") == context.get("varTwo"));
+	}
+};
+
+TEST_F(CompiledOperationsFixture, CompiledMatchesTree)
+{
+	expectSameResults(R"( { "type" : "Value", "data" : 456 } )"_json, 1.5, 2);
+	expectSameResults(R"( { "type" : "Read", "data" : "varOne" } )"_json, 9.625, -14);
+	expectSameResults(R"( { "type" : "Assign", "data" : [ "varTwo", { "type" : "Value", "data" : -159 } ] } )"_json, 0.5, 3);
+	expectSameResults(R"( { "type" : "Clone", "data" : { "type" : "Read", "data" : "varTwo" } } )"_json, 0.5, 7410);
+	expectSameResults(R"( { "type" : "Add", "data" :
+		[ { "type" : "Read", "data" : "varOne" }, { "type" : "Read", "data" : "varTwo" } ] } )"_json, 74.25, 85);
+	expectSameResults(R"( { "type" : "Assign", "data" : [ "varOne", { "type" : "Add", "data" :
+		[ { "type" : "Clone", "data" : { "type" : "Read", "data" : "varTwo" } },
+		  { "type" : "Add", "data" : [ { "type" : "Read", "data" : "varTwo" }, { "type" : "Value", "data" : 11 } ] } ] } ] } )"_json, 3.5, 20);
+}
+
+TEST_F(CompiledOperationsFixture, CompiledRegisters)
+{
+	auto operation = loadOperation(R"( { "type" : "Add", "data" :
+		[ { "type" : "Read", "data" : "varTwo" }, { "type" : "Clone", "data" : { "type" : "Value", "data" : 93 } } ] } )"_json);
+	Program program{ *operation };
+	EXPECT_EQ(program.code.size(), 4);
+	EXPECT_EQ(program.registerCount, 2);
+	EXPECT_EQ(program.constants.size(), 1);
+	EXPECT_EQ(program.variables.size(), 1);
+
+	setTestVariables(0.0, 7);
+	EXPECT_EQ(executor.execute(program).as<TypeInt::ValueType>(), 100);
+	EXPECT_EQ(executor.execute(program).as<TypeInt::ValueType>(), 193);
+	EXPECT_EQ(context.get("varTwo").as<TypeInt::ValueType>(), 193);
 }
\ No newline at end of file
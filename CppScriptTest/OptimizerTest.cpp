@@ -0,0 +1,209 @@
+#include<gtest/gtest.h>
+
+#include <CppScript/Optimizer.h>
+#include <CppScript/Binary.h>
+#include <CppScript/NumericArray.h>
+#include <CppScript/Execution.h>
+
+using namespace CppScript;
+
+class OptimizerFixture : public testing::Test
+{
+protected:
+	Operation::Ref loadOperation(const Json& opData)
+	{
+		JsonLoader data{ opData };
+		Operation::Ref operation;
+		data.serialize(operation);
+		return operation;
+	}
+
+	Value& run(Operation::Ref& operation)
+	{
+		VariableResolver resolver{ context };
+		resolver.serialize(operation);
+		return executor.execute(*operation);
+	}
+
+
+	Context context;
+	Executor executor{ context };
+};
+
+TEST_F(OptimizerFixture, FoldClonedLiteralAdditions)
+{
+	const auto opData = R"( { "type" : "Add", "data" : [
+		{ "type" : "Add", "data" : [ { "type" : "Clone", "data" : { "type" : "Value", "data" : 1 } }, { "type" : "Value", "data" : 2 } ] },
+		{ "type" : "Clone", "data" : { "type" : "Clone", "data" : { "type" : "Value", "data" : 3 } } } ] } )"_json;
+	auto operation = loadOperation(opData);
+	ConstantFolder folder;
+	folder.serialize(operation);
+	EXPECT_EQ(folder.getRemovedCount(), 6);
+	ASSERT_EQ(operation->getType(), OperationType::Clone);
+
+	auto& value = run(operation);
+	EXPECT_EQ(value.as<IntValue>(), 6);
+	value += 10;
+	EXPECT_EQ(run(operation).as<IntValue>(), 6);
+}
+
+TEST_F(OptimizerFixture, FoldUnclonedLiterals)
+{
+	const auto opData = R"( { "type" : "Add", "data" : [ { "type" : "Value", "data" : 1 }, { "type" : "Value", "data" : 2 } ] } )"_json;
+	auto operation = loadOperation(opData);
+	EXPECT_EQ(run(operation).as<IntValue>(), 3);
+	EXPECT_EQ(run(operation).as<IntValue>(), 3);
+	ConstantFolder folder;
+	folder.serialize(operation);
+	EXPECT_EQ(folder.getRemovedCount(), 2);
+	EXPECT_EQ(operation->getType(), OperationType::Value);
+	EXPECT_EQ(run(operation).as<IntValue>(), 3);
+}
+
+TEST_F(OptimizerFixture, KeepFailingAndVariableAdditions)
+{
+	const auto opData = R"( { "type" : "Add", "data" : [
+		{ "type" : "Add", "data" : [ { "type" : "Clone", "data" : { "type" : "Value", "data" : 1 } }, { "type" : "Value", "data" : 2.5 } ] },
+		{ "type" : "Read", "data" : "input" } ] } )"_json;
+	auto operation = loadOperation(opData);
+	ConstantFolder folder;
+	folder.serialize(operation);
+	EXPECT_EQ(folder.getRemovedCount(), 0);
+	context.set("input", 1);
+	EXPECT_THROW(run(operation), InvalidTypeCast);
+}
+
+TEST_F(OptimizerFixture, SpecializeProvenAdditions)
+{
+	const auto opData = R"( { "type" : "ForLoop", "data" : [ "i",
+		{ "type" : "Range", "data" : [ { "type" : "Value", "data" : 0 }, { "type" : "Read", "data" : "count" }, { "type" : "Value", "data" : 1 } ] },
+		{ "type" : "Add", "data" : [ { "type" : "Read", "data" : "total" }, { "type" : "Add", "data" : [
+			{ "type" : "Clone", "data" : { "type" : "Read", "data" : "i" } }, { "type" : "Value", "data" : 1 } ] } ] } ] } )"_json;
+	auto operation = loadOperation(opData);
+	TypeInference inference;
+	inference.declare("count", TypeInt::id());
+	inference.declare("total", TypeFloat::id());
+	inference.serialize(operation);
+	EXPECT_EQ(inference.getSpecializedCount(), 2);
+	EXPECT_EQ(inference.getType(*operation), nullptr);
+
+	context.set("count", 4);
+	context.set("total", 0.5);
+	EXPECT_EQ(run(operation).as<FloatValue>(), 10.5);
+	EXPECT_EQ(context.get("i").as<IntValue>(), 3);
+}
+
+TEST_F(OptimizerFixture, KeepUnprovenAdditions)
+{
+	const auto opData = R"( { "type" : "Add", "data" : [
+		{ "type" : "Clone", "data" : { "type" : "Assign", "data" : [ "x", { "type" : "Value", "data" : 2.5 } ] } },
+		{ "type" : "Add", "data" : [ { "type" : "Clone", "data" : { "type" : "Assign", "data" : [ "x", { "type" : "Value", "data" : 1 } ] } },
+			{ "type" : "Add", "data" : [ { "type" : "Read", "data" : "x" }, { "type" : "Read", "data" : "input" } ] } ] } ] } )"_json;
+	auto operation = loadOperation(opData);
+	TypeInference inference;
+	inference.serialize(operation);
+	EXPECT_EQ(inference.getSpecializedCount(), 0);
+	EXPECT_EQ(inference.getType(*operation), nullptr);
+
+	context.set("input", 2);
+	EXPECT_EQ(run(operation).as<FloatValue>(), 6.5);
+	context.set("input", 0.5);
+	EXPECT_THROW(run(operation), InvalidTypeCast);
+}
+
+TEST_F(OptimizerFixture, KeepAdditionsReadingHostValues)
+{
+	// x holds the host value when it is read, the tree assigns it an int only afterwards
+	const auto opData = R"( { "type" : "Add", "data" : [
+		{ "type" : "Assign", "data" : [ "y", { "type" : "Add", "data" : [ { "type" : "Read", "data" : "x" }, { "type" : "Value", "data" : 1 } ] } ] },
+		{ "type" : "Assign", "data" : [ "x", { "type" : "Value", "data" : 5 } ] } ] } )"_json;
+	auto operation = loadOperation(opData);
+	TypeInference inference;
+	inference.serialize(operation);
+	EXPECT_EQ(inference.getSpecializedCount(), 0);
+
+	context.set("x", 2.5);
+	run(operation);
+	EXPECT_EQ(context.get("y").as<FloatValue>(), 8.5);
+
+	// an assignment evaluated before the read proves its type, as does the loop for its variable
+	const auto provenData = R"( { "type" : "ForLoop", "data" : [ "i",
+		{ "type" : "Range", "data" : [ { "type" : "Value", "data" : 0 }, { "type" : "Value", "data" : 3 }, { "type" : "Value", "data" : 1 } ] },
+		{ "type" : "Add", "data" : [ { "type" : "Assign", "data" : [ "z", { "type" : "Value", "data" : 1 } ] },
+			{ "type" : "Add", "data" : [ { "type" : "Read", "data" : "z" }, { "type" : "Read", "data" : "i" } ] } ] } ] } )"_json;
+	auto proven = loadOperation(provenData);
+	TypeInference provenInference;
+	provenInference.serialize(proven);
+	EXPECT_EQ(provenInference.getSpecializedCount(), 2);
+	context.set("z", 0.5);
+	EXPECT_EQ(run(proven).as<IntValue>(), 6);
+}
+
+TEST_F(OptimizerFixture, FuseCommonShapes)
+{
+	const auto opData = R"( { "type" : "Add", "data" : [
+		{ "type" : "Clone", "data" : { "type" : "Assign", "data" : [ "y", { "type" : "Clone", "data" : { "type" : "Read", "data" : "x" } } ] } },
+		{ "type" : "Add", "data" : [ { "type" : "Assign", "data" : [ "x", { "type" : "Add", "data" : [
+			{ "type" : "Read", "data" : "x" }, { "type" : "Value", "data" : 3 } ] } ] },
+			{ "type" : "Add", "data" : [ { "type" : "Read", "data" : "a" }, { "type" : "Read", "data" : "b" } ] } ] } ] } )"_json;
+	auto operation = loadOperation(opData);
+	OperationFuser fuser;
+	fuser.serialize(operation);
+	fuser.serialize(operation);
+	const auto& statistics = fuser.getStatistics();
+	EXPECT_EQ(statistics.increments, 1);
+	EXPECT_EQ(statistics.variableAdditions, 1);
+	EXPECT_EQ(statistics.cloneAssignments, 1);
+
+	context.set("x", 1);
+	context.set("a", 10);
+	context.set("b", 5);
+	EXPECT_EQ(run(operation).as<IntValue>(), 1 + 4 + 15);
+	EXPECT_EQ(context.get("y").as<IntValue>(), 1);
+	EXPECT_EQ(context.get("x").as<IntValue>(), 19);
+
+	// fused operations serialize as the operations they replace
+	BinaryWriter writer;
+	writer.serialize(operation);
+	auto data = writer.getData();
+	BinaryLoader loader{ data.data(), data.size() };
+	Operation::Ref loaded;
+	loader.serialize(loaded);
+	context.set("x", 1);
+	context.set("a", 10);
+	EXPECT_EQ(run(loaded).as<IntValue>(), 20);
+}
+
+TEST_F(OptimizerFixture, ElideUnobservedClones)
+{
+	const auto opData = R"( { "type" : "Assign", "data" : [ "sum", { "type" : "Clone", "data" : { "type" : "Add", "data" : [
+		{ "type" : "Clone", "data" : { "type" : "Read", "data" : "a" } }, { "type" : "Clone", "data" : { "type" : "Read", "data" : "b" } } ] } } ] } )"_json;
+	for (auto verify : { false, true })
+	{
+		auto operation = loadOperation(opData);
+		CloneElider elider{ verify };
+		elider.serialize(operation);
+		EXPECT_EQ(elider.getRemovedCount(), 2);
+
+		context.set("a", TypeArray::create(NumericArray{ 1ll, 2ll }));
+		context.set("b", TypeArray::create(NumericArray{ 10ll, 20ll }));
+		EXPECT_TRUE(run(operation).as<NumericArray>() == NumericArray({ 11ll, 22ll }));
+		EXPECT_TRUE(context.get("a").as<NumericArray>() == NumericArray({ 1ll, 2ll }));
+		EXPECT_TRUE(context.get("b").as<NumericArray>() == NumericArray({ 10ll, 20ll }));
+		context.get("sum") += 1;
+		EXPECT_TRUE(context.get("a").as<NumericArray>() == NumericArray({ 1ll, 2ll }));
+	}
+}
+
+TEST_F(OptimizerFixture, KeepObservedClones)
+{
+	const auto opData = R"( { "type" : "Add", "data" : [ { "type" : "Assign", "data" : [ "b", { "type" : "Clone", "data" : { "type" : "Read", "data" : "a" } } ] },
+		{ "type" : "Clone", "data" : { "type" : "Read", "data" : "b" } } ] } )"_json;
+	auto operation = loadOperation(opData);
+	CloneElider elider{ true };
+	elider.serialize(operation);
+	EXPECT_EQ(elider.getRemovedCount(), 0);
+	context.set("a", TypeArray::create(NumericArray{ 1ll, 2ll }));
+	EXPECT_TRUE(run(operation).as<NumericArray>() == NumericArray({ 2ll, 4ll }));
+	EXPECT_TRUE(context.get("a").as<NumericArray>() == NumericArray({ 1ll, 2ll }));
+}
\ No newline at end of file
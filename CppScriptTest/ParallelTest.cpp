@@ -0,0 +1,84 @@
+#include<gtest/gtest.h>
+
+#include <CppScript/Parallel.h>
+#include <CppScript/Serializer.h>
+#include <atomic>
+#include <chrono>
+
+using namespace CppScript;
+
+class ParallelFixture : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		JsonLoader data{ script };
+		data.serialize(operation);
+		VariableResolver resolver{ prototype };
+		resolver.serialize(operation);
+	}
+
+	const Json script = R"( { "type" : "Assign", "data" : [ "result", { "type" : "Add", "data" : [
+		{ "type" : "Clone", "data" : { "type" : "Read", "data" : "input" } },
+		{ "type" : "Add", "data" : [ { "type" : "Clone", "data" : { "type" : "Value", "data" : 0.5 } },
+			{ "type" : "Read", "data" : "input" } ] } ] } ] } )"_json;
+
+	Context prototype;
+	Operation::Ref operation;
+};
+
+TEST_F(ParallelFixture, ResultsInInputOrder)
+{
+	std::vector<ParallelRunner::Record> records;
+	for (int i = 0; i < 1000; ++i)
+		records.push_back({ Value{ 0.25 * i } });
+
+	ParallelRunner runner{ *operation, prototype, 4 };
+	runner.setChunkSize(16);
+	auto results = runner.run({ "input" }, records);
+	ASSERT_EQ(results.size(), records.size());
+	for (int i = 0; i < 1000; ++i)
+		EXPECT_EQ(results[i].as<FloatValue>(), 0.5 * i + 0.5);
+
+	const auto& statistics = runner.getStatistics();
+	ASSERT_EQ(statistics.size(), 4);
+	std::size_t processed = 0, tasks = 0;
+	for (const auto& worker : statistics)
+	{
+		processed += worker.records;
+		tasks += worker.tasks;
+	}
+	EXPECT_EQ(processed, 1000);
+	EXPECT_EQ(tasks, 63);
+}
+
+TEST_F(ParallelFixture, ErrorsArePropagated)
+{
+	std::vector<ParallelRunner::Record> records(100, { Value{ 1.5 } });
+	records[42] = { Value{ 3 } };
+	ParallelRunner runner{ *operation, prototype, 3 };
+	runner.setChunkSize(10);
+	EXPECT_THROW(runner.run({ "input" }, records), InvalidTypeCast);
+	records[42] = { Value{ 3.0 } };
+	EXPECT_EQ(runner.run({ "input" }, records)[42].as<FloatValue>(), 6.5);
+}
+
+TEST(WorkStealingPoolTest, IdleWorkersSteal)
+{
+	WorkStealingPool pool{ 2 };
+	std::atomic<int> done{ 0 };
+	std::vector<WorkStealingPool::Task> tasks;
+	for (int i = 0; i < 8; ++i)
+		tasks.push_back([i, &done](std::size_t)
+			{
+				if (i < 4)
+					std::this_thread::sleep_for(std::chrono::milliseconds(20));
+				++done;
+				return std::size_t(1);
+			});
+	pool.run(std::move(tasks));
+	EXPECT_EQ(done, 8);
+	const auto& statistics = pool.getStatistics();
+	EXPECT_EQ(statistics[0].tasks + statistics[1].tasks, 8);
+	EXPECT_GT(statistics[0].stolenTasks + statistics[1].stolenTasks, 0);
+}
\ No newline at end of file
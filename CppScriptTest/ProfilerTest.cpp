@@ -0,0 +1,118 @@
+#include<gtest/gtest.h>
+
+#include <CppScript/Profiler.h>
+#include <CppScript/Execution.h>
+#include <CppScript/JsonStream.h>
+#include <sstream>
+
+using namespace CppScript;
+
+class ProfilerFixture : public testing::Test
+{
+protected:
+	const Operation& findOperation(const std::string& pointer) const
+	{
+		for (const auto& source : sources)
+			if (source.second.pointer == pointer)
+				return *source.first;
+		throw std::out_of_range{ pointer };
+	}
+
+	const std::string script = R"( { "type" : "ForLoop", "data" : [ "i",
+		{ "type" : "Range", "data" : [ { "type" : "Value", "data" : 0 }, { "type" : "Value", "data" : 4.0 }, { "type" : "Value", "data" : 1 } ] },
+		{ "type" : "Assign", "data" : [ "sum", { "type" : "Add", "data" : [
+			{ "type" : "Clone", "data" : { "type" : "Read", "data" : "sum" } }, { "type" : "Read", "data" : "i" } ] } ] } ] } )";
+
+	Context context;
+	Executor executor{ context };
+	SourceMap sources;
+};
+
+TEST_F(ProfilerFixture, SourcePositions)
+{
+	auto data = Json::parse(script);
+	JsonLoader loader{ data };
+	loader.setSourceMap(sources);
+	Operation::Ref operation;
+	loader.serialize(operation);
+	EXPECT_EQ(sources.size(), 10);
+	EXPECT_EQ(sources.at(operation.get()).pointer, "");
+	EXPECT_EQ(findOperation("/data/1/data/1").getType(), OperationType::Value);
+	EXPECT_EQ(findOperation("/data/2/data/1/data/0/data").getType(), OperationType::Read);
+
+	SourceMap streamSources;
+	std::istringstream stream{ script };
+	JsonStreamLoader streamLoader{ stream };
+	streamLoader.setSourceMap(streamSources);
+	Operation::Ref streamed;
+	streamLoader.serialize(streamed);
+	ASSERT_EQ(streamSources.size(), sources.size());
+	for (const auto& source : streamSources)
+	{
+		EXPECT_EQ(script[source.second.offset], '{');
+		EXPECT_EQ(findOperation(source.second.pointer).getType(), source.first->getType());
+	}
+}
+
+TEST_F(ProfilerFixture, CountsAndTimes)
+{
+	auto data = Json::parse(script);
+	JsonLoader loader{ data };
+	loader.setSourceMap(sources);
+	Operation::Ref operation;
+	loader.serialize(operation);
+	VariableResolver resolver{ context };
+	resolver.serialize(operation);
+	Profiler::instrument(operation);
+	context.set("sum", FloatValue(0.5));
+
+	executor.execute(*operation);
+	Profiler profiler;
+	executor.setProfiler(&profiler);
+	EXPECT_EQ(executor.execute(*operation).as<FloatValue>(), 12.5);
+	executor.setProfiler(nullptr);
+	executor.execute(*operation);
+
+	const auto* loop = profiler.getProfile(findOperation(""));
+	ASSERT_NE(loop, nullptr);
+	EXPECT_EQ(loop->calls, 1);
+	// the loop takes the bounds of its range and builds the float array itself, as without profiling
+	EXPECT_EQ(profiler.getProfile(findOperation("/data/1")), nullptr);
+	EXPECT_EQ(profiler.getProfile(findOperation("/data/1/data/1"))->calls, 1);
+	EXPECT_EQ(profiler.getProfile(findOperation("/data/2"))->calls, 4);
+	EXPECT_EQ(profiler.getProfile(findOperation("/data/2/data/1/data/1"))->calls, 4);
+	EXPECT_EQ(loop->allocations, 1);
+
+	auto top = profiler.getTop(3);
+	ASSERT_EQ(top.size(), 3);
+	EXPECT_GE(top[0].exclusiveTime, top[1].exclusiveTime);
+	EXPECT_GE(top[1].exclusiveTime, top[2].exclusiveTime);
+	for (const auto& profile : profiler.getTop(100))
+		EXPECT_LE(profile.exclusiveTime, profile.inclusiveTime);
+
+	std::ostringstream report;
+	profiler.report(report, 100, &sources);
+	EXPECT_NE(report.str().find("ForLoop"), std::string::npos);
+	EXPECT_NE(report.str().find("#/data/2/data/1"), std::string::npos);
+
+	Profiler::strip(operation);
+	EXPECT_EQ(operation.get(), &findOperation(""));
+	EXPECT_EQ(executor.execute(*operation).as<FloatValue>(), 24.5);
+}
+
+TEST_F(ProfilerFixture, IntRangesAreNotBuilt)
+{
+	auto data = Json::parse(script);
+	data["data"][1]["data"][1]["data"] = 4;
+	JsonLoader loader{ data };
+	Operation::Ref operation;
+	loader.serialize(operation);
+	Profiler::instrument(operation);
+	context.set("sum", 0);
+
+	Profiler profiler;
+	executor.setProfiler(&profiler);
+	EXPECT_EQ(executor.execute(*operation).as<IntValue>(), 6);
+	EXPECT_EQ(profiler.getProfile(operation->unwrap())->allocations, 0);
+	EXPECT_EQ(profiler.getTop(100).size(), 9);
+}
\ No newline at end of file
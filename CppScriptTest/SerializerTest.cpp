@@ -0,0 +1,212 @@
+#include<gtest/gtest.h>
+
+#include <CppScript/Serializer.h>
+#include <CppScript/Binary.h>
+#include <CppScript/JsonStream.h>
+#include <CppScript/Execution.h>
+#include <CppScript/NumericArray.h>
+#include <filesystem>
+#include <cstring>
+#include <sstream>
+
+using namespace CppScript;
+
+class SerializerFixture : public testing::Test
+{
+protected:
+	Operation::Ref loadJson(const Json& opData)
+	{
+		JsonLoader data{ opData };
+		Operation::Ref operation;
+		data.serialize(operation);
+		return operation;
+	}
+
+	Operation::Ref loadStream(const std::string& opData)
+	{
+		std::istringstream stream{ opData };
+		JsonStreamLoader loader{ stream };
+		Operation::Ref operation;
+		loader.serialize(operation);
+		return operation;
+	}
+
+	Value& run(Operation::Ref& operation)
+	{
+		VariableResolver resolver{ context };
+		resolver.serialize(operation);
+		return executor.execute(*operation);
+	}
+
+
+	Context context;
+	Executor executor{ context };
+
+	const Json script = R"( { "type" : "Assign", "data" : [ "result", { "type" : "Add", "data" : [
+		{ "type" : "Clone", "data" : { "type" : "Read", "data" : "input" } },
+		{ "type" : "Add", "data" : [ { "type" : "Clone", "data" : { "type" : "Value", "data" : 2.5 } },
+			{ "type" : "Read", "data" : "input" } ] } ] } ] } )"_json;
+};
+
+TEST_F(SerializerFixture, BinaryRoundTrip)
+{
+	auto operation = loadJson(script);
+	BinaryWriter writer;
+	writer.serialize(operation);
+	auto data = writer.getData();
+
+	BinaryLoader loader{ data.data(), data.size() };
+	Operation::Ref loaded;
+	loader.serialize(loaded);
+	ASSERT_TRUE(bool(loaded));
+	EXPECT_EQ(loaded->getType(), OperationType::Assign);
+
+	context.set("input", 4.0);
+	EXPECT_EQ(run(loaded).as<FloatValue>(), 10.5);
+	EXPECT_EQ(context.get("result").as<FloatValue>(), 10.5);
+}
+
+TEST_F(SerializerFixture, BinaryStringsAreShared)
+{
+	auto operation = loadJson(script);
+	BinaryWriter writer;
+	writer.serialize(operation);
+	auto data = writer.getData();
+
+	BinaryHeader header;
+	std::memcpy(&header, data.data(), sizeof(header));
+	EXPECT_EQ(header.stringCount, 2);
+	EXPECT_EQ(header.version, BinaryHeader::currentVersion);
+}
+
+TEST_F(SerializerFixture, BinaryFileIsMapped)
+{
+	auto operation = loadJson(script);
+	BinaryWriter writer;
+	writer.serialize(operation);
+	auto fileName = (std::filesystem::temp_directory_path() / "CppScriptBinaryTest.csbp").string();
+	writer.save(fileName);
+
+	auto loaded = loadBinaryProgram(fileName);
+	std::filesystem::remove(fileName);
+	ASSERT_TRUE(bool(loaded));
+	context.set("input", -1);
+	EXPECT_THROW(run(loaded), InvalidTypeCast);
+	context.set("input", 1.5);
+	EXPECT_EQ(run(loaded).as<FloatValue>(), 5.5);
+}
+
+TEST_F(SerializerFixture, BinaryInvalidData)
+{
+	auto operation = loadJson(script);
+	BinaryWriter writer;
+	writer.serialize(operation);
+	auto data = writer.getData();
+
+	EXPECT_THROW((BinaryLoader{ data.data(), 8 }), InvalidBinaryProgram);
+	BinaryLoader truncated{ data.data(), data.size() - 3 };
+	Operation::Ref loaded;
+	EXPECT_THROW(truncated.serialize(loaded), InvalidBinaryProgram);
+
+	// string counts and sizes beyond the data are rejected before anything is reserved
+	auto withHeader = [&data](auto change)
+	{
+		auto changed = data;
+		BinaryHeader header;
+		std::memcpy(&header, changed.data(), sizeof(header));
+		change(header);
+		std::memcpy(changed.data(), &header, sizeof(header));
+		return changed;
+	};
+	for (auto& changed : { withHeader([](BinaryHeader& header) { header.stringCount = 0xffffffff; }),
+		withHeader([](BinaryHeader& header) { header.stringTableSize = 0xfffffff0; }),
+		withHeader([](BinaryHeader& header) { --header.stringTableSize; }),
+		withHeader([](BinaryHeader& header) { --header.stringCount; }) })
+	{
+		EXPECT_THROW((BinaryLoader{ changed.data(), changed.size() }), InvalidBinaryProgram);
+	}
+	data[0] = 'X';
+	EXPECT_THROW((BinaryLoader{ data.data(), data.size() }), InvalidBinaryProgram);
+}
+
+TEST_F(SerializerFixture, StreamMatchesJsonLoader)
+{
+	auto loaded = loadStream(script.dump(1, '\t'));
+	ASSERT_TRUE(bool(loaded));
+	EXPECT_EQ(loaded->getType(), OperationType::Assign);
+	context.set("input", 4.0);
+	EXPECT_EQ(run(loaded).as<FloatValue>(), 10.5);
+
+	auto typeFirst = loadStream(R"( { "type" : "Assign", "data" : [ "result", { "type" : "Add", "data" : [
+		{ "type" : "Clone", "data" : { "type" : "Read", "data" : "input" } },
+		{ "type" : "Add", "data" : [ { "type" : "Clone", "data" : { "type" : "Value", "data" : 2.5 } },
+			{ "type" : "Read", "data" : "input" } ] } ] } ] } )");
+	ASSERT_TRUE(bool(typeFirst));
+	EXPECT_EQ(run(typeFirst).as<FloatValue>(), 10.5);
+}
+
+TEST_F(SerializerFixture, StreamFieldOrderAndExtras)
+{
+	auto loaded = loadStream(R"( { "comment" : { "note" : [ 1, "}" ] }, "data" : [ "re\u0073ult", { "data" : 3, "type" : "Value" } ],
+		"type" : "Assign" } )");
+	ASSERT_TRUE(bool(loaded));
+	EXPECT_EQ(run(loaded).as<IntValue>(), 3);
+	EXPECT_EQ(context.get("result").as<IntValue>(), 3);
+	EXPECT_EQ(loadStream(R"({"type":"Value","data":true})")->execute(executor).as<BoolValue>(), true);
+
+	auto array = loadStream(R"( { "data" : [ 1, 2.5 ], "type" : "Value" } )");
+	EXPECT_TRUE(array->execute(executor) == Value{ TypeArray::create(NumericArray{ 1.0, 2.5 }) });
+	EXPECT_THROW(loadStream(R"( { "data" : [ 1, true ], "type" : "Value" } )"), NotBaseType);
+	EXPECT_THROW(loadStream(R"( { "data" : [ "x" ], "type" : "Assign" } )"), InvalidJson);
+}
+
+TEST_F(SerializerFixture, StreamInvalidJson)
+{
+	EXPECT_THROW(loadStream(R"( { "type" : "Value", "data" : 1 )"), InvalidJson);
+	EXPECT_THROW(loadStream(R"( { "type" : "Read", "data" : "x" ] )"), InvalidJson);
+	EXPECT_THROW(loadStream(R"( { "type" : "Value" } )"), InvalidJson);
+	EXPECT_THROW(loadStream(R"( { "type" : "Value", "data" : 1x } )"), InvalidJson);
+	EXPECT_THROW(loadStream(R"( { "type" : "Value", "data" : "text" } )"), NotBaseType);
+	// numbers follow the JSON grammar, as JsonLoader reads them
+	for (const char* number : { "0x1A", "inf", "-inf", "nan", "+5", ".5", "1.", "01", "1e", "-", "1.5e+" })
+	{
+		EXPECT_THROW(loadStream(std::string{ R"( { "type" : "Value", "data" : )" } + number + " }"), InvalidJson) << number;
+	}
+	EXPECT_EQ(loadStream(R"( { "type" : "Value", "data" : -0.5e1 } )")->execute(executor).as<FloatValue>(), -5.0);
+	EXPECT_EQ(loadStream(R"( { "type" : "Value", "data" : 1E2 } )")->execute(executor).as<FloatValue>(), 100.0);
+	EXPECT_EQ(loadStream(R"( { "type" : "Value", "data" : -12 } )")->execute(executor).as<IntValue>(), -12);
+
+	auto errorOf = [this](const std::string& opData) -> std::string
+	{
+		try
+		{
+			loadStream(opData);
+		}
+		catch (const InvalidJson& error)
+		{
+			return error.what();
+		}
+		return {};
+	};
+	EXPECT_EQ(errorOf(R"( { "type" : "Value" } )"), "Invalid JSON at position 1: operation data is missing");
+	EXPECT_EQ(errorOf(R"({ "type" : "Add", "data" : [ { "data" : 1 } ] })"), "Invalid JSON at position 29: operation type is missing");
+}
+
+TEST_F(SerializerFixture, NamesAreInterned)
+{
+	Symbol input{ "input" };
+	EXPECT_EQ(input, Symbol{ std::string{ "in" } + "put" });
+	EXPECT_EQ(&input.str(), &Symbol{ "input" }.str());
+	EXPECT_NE(input, Symbol{ "result" });
+	EXPECT_FALSE(Symbol::find("neverInternedName").has_value());
+	EXPECT_EQ(Symbol::find("input"), input);
+
+	context.set(input, 2);
+	EXPECT_EQ(context.get("input").as<IntValue>(), 2);
+	EXPECT_EQ(context.getSlot("input"), context.getSlot(input));
+
+	EXPECT_THROW(loadJson(R"({"type":"Unknown","data":1})"_json), std::invalid_argument);
+	EXPECT_THROW(loadJson(R"({"type":"Add","data":[{"type":"Unknown","data":1},{"type":"Value","data":1}]})"_json), std::invalid_argument);
+	EXPECT_THROW(loadStream(R"({"type":"Unknown","data":1})"), InvalidJson);
+	EXPECT_FALSE(Symbol::find("Unknown").has_value());
+}
\ No newline at end of file
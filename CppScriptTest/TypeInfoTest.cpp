@@ -13,6 +13,11 @@ TEST(TypeInfoTestCase, GetTypeName)
 {
 	EXPECT_EQ(getTypeName<int>(), "int");
 	EXPECT_EQ(getTypeName<float>(), "float");
+#ifdef _MSC_VER
 	EXPECT_EQ(getTypeName<FirstToTest>(), "class FirstToTest");
 	EXPECT_EQ(getTypeName<SecName>(), "class SecName");
+#else
+	EXPECT_EQ(getTypeName<FirstToTest>(), "FirstToTest");
+	EXPECT_EQ(getTypeName<SecName>(), "SecName");
+#endif
 }
\ No newline at end of file
@@ -2,6 +2,10 @@
 
 #include <CppScript/Types.h>
 #include <CppScript/BasicTypes.h>
+#include <CppScript/Value.h>
+#include <CppScript/Dispatch.h>
+#include <CppScript/Serializer.h>
+#include <CppScript/Execution.h>
 
 using namespace CppScript;
 
@@ -21,14 +25,14 @@ TEST(TypesTest, BaseTypesCasts)
 
 	EXPECT_EQ(TypeInt::id().get(*intVal), 15);
 	EXPECT_THROW(TypeInt::id().get(*floatVal), InvalidTypeCast);
-	EXPECT_EQ(TypeFloat::id().get(*floatVal), 47.58);
+	EXPECT_EQ(TypeFloat::id().get(*floatVal), TypeFloat::ValueType(47.58));
 	EXPECT_THROW(TypeFloat::id().get(*intVal), InvalidTypeCast);
 	EXPECT_EQ(TypeBool::id().get(*boolVal), true);
 	EXPECT_THROW(TypeBool::id().get(*floatVal), InvalidTypeCast);
 
 	EXPECT_EQ(intVal->as<long long>(), 15);
 	EXPECT_EQ(intVal->as<short>(), 15);
-	EXPECT_EQ(floatVal->as<double>(), 47.58);
+	EXPECT_EQ(floatVal->as<double>(), double(TypeFloat::ValueType(47.58)));
 	EXPECT_EQ(floatVal->as<float>(), 47.58f);
 }
 
@@ -41,9 +45,11 @@ TEST(TypesTest, BaseTypesCastOverflow)
 	using ShortValueOverflow = ValueOverflow<short, TypeInt::ValueType>;
 	EXPECT_THROW(largeIntVal->as<short>(), ShortValueOverflow);
 
-	EXPECT_EQ(largeFloatVal->as<double>(), 1.234e40);
+#if !defined(CPPSCRIPT_FLOAT_SINGLE)
+	EXPECT_EQ(largeFloatVal->as<double>(), double(TypeFloat::ValueType(1.234e40)));
 	using FloatValueOverflow = ValueOverflow<float, TypeFloat::ValueType>;
 	EXPECT_THROW(largeFloatVal->as<float>(), FloatValueOverflow);
+#endif
 }
 
 
@@ -66,7 +72,7 @@ TEST(TypesTest, AddOperatorCastIntToFloat)
 	auto intVal = TypeInt::create(345);
 
 	(*floatVal) += *intVal;
-	EXPECT_EQ(floatVal->get(), 470.7);
+	EXPECT_EQ(floatVal->get(), TypeFloat::ValueType(125.7) + 345);
 	EXPECT_EQ(intVal->get(), 345);
 
 	EXPECT_THROW((*intVal) += *floatVal, InvalidTypeCast);
@@ -85,4 +91,183 @@ TEST(TypesTest, CloneBool)
 	EXPECT_EQ(otherTrueVal, TypeBool::trueValue);
 	auto otherFalseVal = falseVal->clone();
 	EXPECT_EQ(otherFalseVal, TypeBool::falseValue);
+}
+
+
+TEST(ValueTest, PrimitivesAreInline)
+{
+	Value intVal{ 15 };
+	Value floatVal{ 47.58 };
+	Value boolVal{ true };
+	EXPECT_EQ(intVal.getKind(), Value::Kind::Int);
+	EXPECT_EQ(floatVal.getKind(), Value::Kind::Float);
+	EXPECT_EQ(boolVal.getKind(), Value::Kind::Bool);
+	EXPECT_TRUE(Value{}.isNone());
+	EXPECT_FALSE(bool(intVal.getObject()));
+
+	EXPECT_EQ(Value{ TypeInt::create(15) }.getKind(), Value::Kind::Int);
+	EXPECT_EQ(Value{ TypeFloat::create(47.58) }.getKind(), Value::Kind::Float);
+	EXPECT_EQ(Value{ TypeBool::trueValue }.getKind(), Value::Kind::Bool);
+	EXPECT_EQ(intVal.box()->as<IntValue>(), 15);
+}
+
+#if !defined(CPPSCRIPT_FLOAT_SINGLE) && !defined(CPPSCRIPT_FLOAT_EXTENDED)
+TEST(ValueTest, DefaultFloatProfile)
+{
+	EXPECT_TRUE((std::is_same_v<FloatValue, double>));
+	EXPECT_EQ(sizeof(Value), 2 * sizeof(double));
+
+	Value floatVal{ 0.1f };
+	EXPECT_EQ(floatVal.as<FloatValue>(), double(0.1f));
+	floatVal += 2;
+	EXPECT_EQ(floatVal.as<double>(), double(0.1f) + 2.0);
+	EXPECT_TRUE(Value{ 1ll << 53 } == Value{ 9007199254740992.0 });
+}
+#endif
+
+TEST(ValueTest, ValueCasts)
+{
+	Value intVal{ 0x789456ab };
+	Value floatVal{ 1.234e40 };
+	Value boolVal{ false };
+
+	EXPECT_EQ(intVal.getId(), TypeInt::id());
+	EXPECT_EQ(floatVal.getId(), TypeFloat::id());
+	EXPECT_EQ(boolVal.getId(), TypeBool::id());
+	EXPECT_EQ(Value{}.getId(), Value::noneId());
+
+	EXPECT_EQ(intVal.as<int>(), 0x789456ab);
+	using ShortValueOverflow = ValueOverflow<short, TypeInt::ValueType>;
+	EXPECT_THROW(intVal.as<short>(), ShortValueOverflow);
+	EXPECT_THROW(intVal.as<double>(), InvalidTypeCast);
+#if !defined(CPPSCRIPT_FLOAT_SINGLE)
+	EXPECT_EQ(floatVal.as<double>(), double(FloatValue(1.234e40)));
+	using FloatValueOverflow = ValueOverflow<float, TypeFloat::ValueType>;
+	EXPECT_THROW(floatVal.as<float>(), FloatValueOverflow);
+#endif
+	EXPECT_THROW(floatVal.as<IntValue>(), InvalidTypeCast);
+	EXPECT_FALSE(boolVal.as<BoolValue>());
+	EXPECT_THROW(boolVal.as<IntValue>(), InvalidTypeCast);
+}
+
+TEST(ValueTest, AddOperator)
+{
+	Value intVal{ 125 };
+	Value floatVal{ 125.5 };
+
+	intVal += 3459;
+	EXPECT_EQ(intVal.as<IntValue>(), 3584);
+	floatVal += intVal;
+	EXPECT_EQ(floatVal.as<FloatValue>(), 3709.5);
+	EXPECT_EQ(intVal.as<IntValue>(), 3584);
+
+	EXPECT_THROW(intVal += floatVal, InvalidTypeCast);
+	EXPECT_THROW(Value{ true } += intVal, InvalidOperation);
+	EXPECT_TRUE(intVal == Value{ 3584.0 });
+	EXPECT_TRUE(intVal < floatVal);
+	EXPECT_FALSE(floatVal < intVal);
+}
+
+struct TestText
+{
+	std::string text;
+};
+
+template<> TypeId<TestText> Type<TestText>::typeId{ "text" };
+
+TEST(ValueTest, DispatchTables)
+{
+	EXPECT_NE(TypeInt::id().getIndex(), TypeFloat::id().getIndex());
+	EXPECT_NE(TypeBool::id().getIndex(), Value::noneId().getIndex());
+	EXPECT_EQ(Value{ 2.5 }.getTypeIndex(), TypeFloat::id().getIndex());
+
+	Value text{ Type<TestText>::create() };
+	EXPECT_EQ(text.getTypeIndex(), Type<TestText>::id().getIndex());
+	EXPECT_THROW(text += 4, InvalidOperation);
+	OperatorTables::getAdd().set(Type<TestText>::id(), TypeInt::id(), [](Value& destination, const Value& source) -> Expected<Value*>
+		{
+			destination.as<TestText>().text += std::to_string(source.as<IntValue>());
+			return &destination;
+		});
+	text += 4;
+	text += 2;
+	EXPECT_EQ(text.as<TestText>().text, "42");
+	EXPECT_THROW(text += 2.5, InvalidOperation);
+
+	Value intVal{ 3 };
+	intVal += 4;
+	EXPECT_EQ(intVal.as<IntValue>(), 7);
+}
+
+TEST(ValueTest, CloneIsCopy)
+{
+	Value intVal{ 7410 };
+	auto cloned = intVal.clone();
+	cloned += 85;
+	EXPECT_EQ(intVal.as<IntValue>(), 7410);
+	EXPECT_EQ(cloned.as<IntValue>(), 7495);
+
+	// whole ints are copied under every float profile
+	Value wide{ 0x123456789ll };
+	auto copied = wide;
+	auto moved = std::move(copied);
+	EXPECT_EQ(moved.as<IntValue>(), 0x123456789ll);
+}
+
+TEST(ValueTest, UnclonableObjectsStayShared)
+{
+	Context context;
+	context.set("t", Value{ Type<TestText>::create() });
+	auto opData = R"( { "type" : "Assign", "data" : [ "u", { "type" : "Read", "data" : "t" } ] } )"_json;
+	JsonLoader data{ opData };
+	Operation::Ref assignment;
+	data.serialize(assignment);
+	Executor{ context }.execute(*assignment);
+
+	EXPECT_TRUE(context.get("t").isShared());
+	context.get("t").as<TestText>().text = "shared";
+	EXPECT_EQ(context.get("u").as<TestText>().text, "shared");
+	EXPECT_EQ(&context.get("u").as<TestText>(), &context.get("t").as<TestText>());
+}
+
+TEST(TypesTest, CreateAndCloneArePooled)
+{
+	TypePool::resetStatistics();
+	auto accumulator = TypeInt::create(0);
+	for (int i = 0; i < 100; ++i)
+	{
+		auto copy = accumulator->clone();
+		(*copy) += TypeInt{ i };
+		accumulator = TypeInt::Ref{ static_cast<TypeInt*>(copy.get()) };
+	}
+	EXPECT_EQ(accumulator->get(), 4950);
+
+	const auto& statistics = TypePool::getStatistics();
+	EXPECT_EQ(statistics.allocations, 101);
+	EXPECT_EQ(statistics.deallocations, 100);
+	EXPECT_EQ(statistics.poolHits + statistics.systemAllocations, statistics.allocations);
+	EXPECT_LE(statistics.systemAllocations, 2);
+}
+
+TEST(TypesTest, IntrusiveReferences)
+{
+	auto intVal = TypeInt::create(5);
+	EXPECT_EQ(intVal->getReferenceCount(), 1);
+	TypeBase::Ref baseRef = intVal;
+	EXPECT_EQ(intVal->getReferenceCount(), 2);
+	EXPECT_EQ(baseRef, intVal);
+
+	auto sum = (*baseRef) += TypeInt{ 3 };
+	EXPECT_NE(sum, intVal);
+	EXPECT_EQ(sum->as<IntValue>(), 8);
+	EXPECT_EQ(intVal->get(), 5);
+	baseRef.reset();
+	sum = (*intVal) += TypeInt{ 3 };
+	EXPECT_EQ(sum, intVal);
+	sum.reset();
+	EXPECT_EQ(intVal->getReferenceCount(), 1);
+	EXPECT_EQ(intVal->get(), 8);
+
+	TypeInt unowned{ 4 };
+	EXPECT_THROW(unowned += TypeInt{ 1 }, std::bad_weak_ptr);
 }
\ No newline at end of file